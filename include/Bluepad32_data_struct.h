@@ -59,15 +59,57 @@ namespace ControllerMiscConst
     static constexpr uint8_t kButtonCapture = 0x08;
 }
 
+// Change mask bits of PackedControllerData fields
+namespace ControllerFieldConst
+{
+    static constexpr uint16_t kFieldId = 0x001;
+    static constexpr uint16_t kFieldDpad = 0x002;
+    static constexpr uint16_t kFieldAxisX = 0x004;
+    static constexpr uint16_t kFieldAxisY = 0x008;
+    static constexpr uint16_t kFieldAxisRX = 0x010;
+    static constexpr uint16_t kFieldAxisRY = 0x020;
+    static constexpr uint16_t kFieldBrake = 0x040;
+    static constexpr uint16_t kFieldThrottle = 0x080;
+    static constexpr uint16_t kFieldButtons = 0x100;
+    static constexpr uint16_t kFieldMiscButtons = 0x200;
+    static constexpr uint16_t kFieldGyro = 0x400;
+    static constexpr uint16_t kFieldAccel = 0x800;
+    static constexpr uint16_t kFieldAxes = kFieldAxisX | kFieldAxisY | kFieldAxisRX | kFieldAxisRY |
+                                           kFieldBrake | kFieldThrottle;
+    static constexpr uint16_t kFieldAll = 0xFFF;
+}
+
+class ControllerDataManager;
+
+// Called from setControllerData when a subscribed field changed,
+// changed_fields holds all fields changed by this update, not only subscribed ones
+using ControllerChangeCallback = void (*)(void *context, const ControllerDataManager &manager,
+                                          uint16_t changed_fields);
+
 class ControllerDataManager {
 public:
+    static constexpr uint8_t kMaxSubscriptions = 2;
+
     ControllerDataManager();
     explicit ControllerDataManager(const PackedControllerData &data);
     ControllerDataManager& operator=(const PackedControllerData &data);
     ~ControllerDataManager() = default;
 
-    void setControllerData(const PackedControllerData &data);
+    // store new data and notify subscribers of changed fields
+    // @return mask of changed fields (ControllerFieldConst)
+    uint16_t setControllerData(const PackedControllerData &data);
     PackedControllerData getControllerData() const;
+    // access stored data without copy
+    const PackedControllerData& controllerData() const { return _controller_data; }
+    // get fields changed by last setControllerData
+    uint16_t changedFields() const { return _changed_fields; }
+    bool hasChanged(uint16_t fields) const { return _changed_fields & fields; }
+
+    // call callback with context whenever one of fields changes
+    // @return false if all subscriptions are used
+    bool subscribe(uint16_t fields, ControllerChangeCallback callback, void *context);
+    // remove subscription registered with the same callback and context
+    void unsubscribe(ControllerChangeCallback callback, void *context);
 
     bool isControllerConnected() const {
         return _controller_data.id != -1;
@@ -112,6 +154,16 @@ public:
     bool miscCapture() const { return miscButtons() & ControllerMiscConst::kButtonCapture; }
 
 private:
+    struct Subscription {
+        ControllerChangeCallback callback;
+        void *context;
+        uint16_t fields;
+    };
+
+    static uint16_t compareFields(const PackedControllerData &previous, const PackedControllerData &data);
+
     PackedControllerData _controller_data;
+    uint16_t _changed_fields;
+    Subscription _subscriptions[kMaxSubscriptions];
 };
 } // namespace BP32Data
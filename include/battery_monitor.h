@@ -0,0 +1,74 @@
+#ifndef BATTERY_MONITOR_H_
+#define BATTERY_MONITOR_H_
+
+#include <Arduino.h>
+
+// Battery states ordered from best to worst, each one degrades the controller further
+enum class BatteryState : uint8_t
+{
+    kNormal,    // full functionality
+    kLow,       // reduced transmission rate
+    kCritical,  // reduced PA level, BLE disabled
+    kDying      // final frame sent, controller stops transmitting
+};
+
+// Samples battery voltage in integer millivolts, filters it and tracks degradation state
+class BatteryMonitor
+{
+public:
+    // Value returned when remaining runtime cannot be estimated yet
+    static constexpr uint16_t kUnknownRuntime = 0xFFFF;
+
+    // @param voltage_pin: analog pin connected to battery
+    explicit BatteryMonitor(int voltage_pin);
+
+    // Destructor
+    ~BatteryMonitor() = default;
+
+    // Take first sample and seed filter
+    void Initialize();
+
+    // Sample voltage when sample period elapsed and update state
+    // @return true if battery state changed
+    bool Update();
+
+    // Get current battery state
+    BatteryState GetState() const { return state_; }
+
+    // Get filtered battery voltage (in millivolts)
+    uint16_t GetVoltageMv() const { return static_cast<uint16_t>(filtered_mv_q_ >> kFilterShift); }
+
+    // Get estimated time until shutdown (in minutes), kUnknownRuntime if not known
+    uint16_t GetRemainingRuntimeMin() const;
+
+    // Check if battery is connected (controller can be powered from USB only)
+    bool IsBatteryConnected() const;
+
+    // Convert state to string for logging
+    static const char* StateToString(BatteryState state);
+
+private:
+    // Constants
+    static constexpr uint8_t kFilterShift = 2;  // EMA filter weight 1/4
+
+    // Read single voltage sample (in millivolts)
+    uint16_t ReadVoltageMv() const;
+
+    // Compute new state from filtered voltage with hysteresis
+    BatteryState EvaluateState(uint16_t voltage_mv) const;
+
+    // Update discharge rate from filtered voltage
+    void UpdateDischargeRate(uint32_t now_ms);
+
+    // Member variables
+    int voltage_pin_;
+    uint32_t filtered_mv_q_;            // filtered voltage scaled by 2^kFilterShift
+    uint32_t last_sample_ms_;
+    uint32_t rate_window_start_ms_;
+    uint16_t rate_window_start_mv_;
+    uint16_t discharge_mv_per_hour_;
+    BatteryState state_;
+    bool is_initialized_;
+};
+
+#endif // BATTERY_MONITOR_H_
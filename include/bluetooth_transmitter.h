@@ -2,6 +2,8 @@
 #define BLUETOOTH_TRANSMITTER_H_
 
 #include <Arduino.h>
+#include "transport.h"
+#include "joystick_shield_struct.h"
 
 // Command types for communication protocol
 enum class CommandType : char
@@ -13,11 +15,45 @@ enum class CommandType : char
     kPidSetting1 = 'C',
     kPidSetting2 = 'D',
     kPidSetting3 = '3',
-    kPidSetting4 = '4'
+    kPidSetting4 = '4',
+    kPidBatch = 'P'
+};
+
+// Single parameter of batched PID transfer
+struct PidParameter
+{
+    CommandType type;   // kPidSetting1 .. kPidSetting4
+    int16_t value_q8;   // signed fixed-point value, 8 fractional bits (256 = 1.0)
+};
+
+// State of last batched PID transfer
+enum class PidBatchState : uint8_t
+{
+    kIdle,      // nothing sent yet
+    kPending,   // sent, waiting for acknowledge
+    kAcked,     // robot acknowledged batch
+    kFailed     // no acknowledge after all retries
+};
+
+// Message types received from robot, terminated with message delimiter
+enum class ResponseType : char
+{
+    kHeartbeat = 'H',   // periodic keep-alive
+    kAck = 'K'          // acknowledge, followed by acknowledged CommandType (and sequence of kPidBatch)
+};
+
+// State of Bluetooth link
+enum class BleLinkState : uint8_t
+{
+    kOff,           // serial port closed
+    kSettingBaud,   // baud change requested at default baud rate, waiting for module response
+    kVerifyingBaud, // AT sent at target baud rate, waiting for module response
+    kDisconnected,  // at target baud rate, no heartbeat from robot
+    kConnected      // heartbeat received within timeout, only reached with confirmed baud rate
 };
 
 // Controller class for sending commands via Bluetooth serial
-class BluetoothTransmitter
+class BluetoothTransmitter : public Transport
 {
 public:
     // Default constructor using predefined TX and RX pins
@@ -26,11 +62,17 @@ public:
     BluetoothTransmitter(HardwareSerial* serial_ble);
 
     // Destructor
-    ~BluetoothTransmitter() = default;
+    ~BluetoothTransmitter() override = default;
 
-    // Initialize the Bluetooth connection
+    // Start initialization of the Bluetooth connection, module setup continues in Update
     bool Initialize();
 
+    // Process received bytes and advance link state, call every loop iteration
+    void Update();
+
+    // Close the Bluetooth connection, commands are rejected until next Initialize
+    void Shutdown();
+
     // Send speed control command (first pad)
     // @param x_value: X-axis value (-127 to 127)
     // @param y_value: Y-axis value (-127 to 127)
@@ -53,39 +95,129 @@ public:
     bool SendPidSetting3(const String &data = "");
     bool SendPidSetting4(const String &data = "");
 
+    // Send several PID parameters in one frame, robot acknowledges the whole batch.
+    // Frame: 'P', 2 hex digits of sequence number, per parameter type char + 4 hex digits
+    // of value, 2 hex digits of xor checksum, delimiter. Acknowledge is 'K', 'P' and the
+    // sequence number, so a late acknowledge of an earlier batch is ignored.
+    // Built in a fixed buffer, retried from Update until acknowledged.
+    // @return false if frame is invalid or previous batch is still pending
+    bool SendPidBatch(const PidParameter* params, uint8_t count);
+
+    // Get state of last batched PID transfer
+    PidBatchState GetPidBatchState() const { return pid_batch_state_; }
+
     // Send raw command string
     bool SendRawCommand(const String &command);
 
-    // Check if connection is available
+    // Check if robot heartbeat was received within timeout
     bool IsConnected() const;
 
-    // Get last command sent
-    String GetLastCommand() const { return last_command_; }
+    // Check if serial port is open (Initialize called and not shut down)
+    bool IsInitialized() const { return is_initialized_; }
+
+    // Get current link state
+    BleLinkState GetLinkState() const { return link_state_; }
+
+    // Check if module answered AT or robot message was parsed at target baud rate
+    bool IsBaudConfirmed() const { return is_baud_confirmed_; }
+
+    // Get command type of last acknowledge received from robot, 0 if none
+    char GetLastAck() const { return last_ack_; }
+
+    // Transport interface, sends left stick of frame as speed command
+    bool sendFrame(const BP32Data::PackedControllerData &data) override;
+    bool isReady() const override { return IsConnected(); }
+    const char* name() const override { return "BLE"; }
+
+    // Take speed of sendFrame from calibrated stick instead of mapped axis_x / axis_y.
+    // Robot protocol is stick speed, so BLE steering works with every input mapping profile.
+    // @param joystick: data updated every tick, nullptr returns to mapped axes
+    void SetStickSource(const JoystickData* joystick) { stick_source_ = joystick; }
+
+    // Get last command sent, empty before first one
+    const char* GetLastCommand() const { return last_command_; }
 
     // Get time since last command was sent (in milliseconds)
-    unsigned long GetTimeSinceLastCommand() const;
+    uint32_t GetTimeSinceLastCommand() const;
 
 private:
     // Constants
     static constexpr uint32_t kBaudRate = 9600;
+    static constexpr uint32_t kTargetBaudRate = 38400;
+    static constexpr uint32_t kAtResponseTimeoutMs = 300;
+    static constexpr uint8_t kBaudMaxAttempts = 3;
+    static constexpr uint32_t kUnconfirmedBaudTimeoutMs = 3000;   // restart baud setup without robot message
+    static constexpr uint32_t kHeartbeatTimeoutMs = 1500;
+    static constexpr size_t kRxBufferSize = 16;
+    static constexpr uint8_t kMaxBatchParams = 5;   // 1 + 2 + 5 * 5 + 2 + 1 bytes fits into kMaxCommandLength
+    static constexpr uint32_t kBatchAckTimeoutMs = 200;
+    static constexpr uint8_t kBatchMaxRetries = 3;
     static constexpr char kMessageDelimiter = '*';
     static constexpr int16_t kMinPadValue = -127;
     static constexpr int16_t kMaxPadValue = 127;
     static constexpr size_t kMaxCommandLength = 32;
+    static constexpr uint8_t kFrameAxisShift = 2;  // frame axis +-512 to pad value +-127
+
+    // Format pad command into buffer without heap allocation
+    // @return command length
+    static size_t BuildPadCommand(CommandType type, int16_t x_value, int16_t y_value,
+                                  char (&command)[kMaxCommandLength + 1]);
+
+    // Append decimal value to buffer
+    // @return number of characters written
+    static size_t AppendDecimal(char* buffer, int16_t value);
 
-    // Helper method to build pad command string
-    String BuildPadCommand(CommandType type, int16_t x_value, int16_t y_value);
+    // Send command via serial and remember it as last command
+    bool SendCommand(const char* command, size_t length);
 
-    // Helper method to send command via serial
-    bool SendCommand(const String &command);
+    // Write command buffer to serial without touching last_command_
+    bool WriteCommand(const char* command, size_t length);
+
+    // Resend pending PID batch or give up after kBatchMaxRetries
+    void UpdatePidBatch();
 
     // Validate pad values are within range
     bool ValidatePadValues(int16_t x_value, int16_t y_value) const;
 
+    // Read available bytes without blocking
+    void ReadResponses();
+
+    // Handle complete message from robot
+    void HandleMessage();
+
+    // Parse two hex digits
+    // @return value 0 - 255, -1 if a digit is invalid
+    static int ParseHexByte(const char* digits);
+
+    // Send baud change at default baud rate of the module
+    void StartBaudSetup();
+
+    // Handle AT response during module setup
+    void HandleAtResponse();
+
+    // Change link state and remember when it happened
+    void SetLinkState(BleLinkState state);
+
     // Member variables
     HardwareSerial* serial_ble_;
-    String last_command_;
-    unsigned long last_command_time_;
+    const JoystickData* stick_source_;
+    char last_command_[kMaxCommandLength + 1];
+    uint32_t last_command_time_;
+    bool has_sent_command_;     // last_command_time_ is valid, millis() may be 0 when it is taken
+    uint32_t state_time_ms_;
+    uint32_t last_rx_ms_;
+    char rx_buffer_[kRxBufferSize];
+    uint8_t rx_length_;
+    char last_ack_;
+    char pid_batch_frame_[kMaxCommandLength + 1];
+    uint8_t pid_batch_length_;
+    uint8_t pid_batch_retries_;
+    uint8_t pid_batch_sequence_;    // sequence of last batch, retries keep it
+    uint32_t pid_batch_time_ms_;
+    PidBatchState pid_batch_state_;
+    BleLinkState link_state_;
+    bool is_baud_confirmed_;
+    uint8_t baud_attempts_;     // AT+BAUD3 sent since setup (re)started
     bool is_initialized_;
 };
 
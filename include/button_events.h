@@ -0,0 +1,76 @@
+#ifndef BUTTON_EVENTS_H_
+#define BUTTON_EVENTS_H_
+
+#include <Arduino.h>
+#include "spsc_ring.h"
+
+// Types of button events
+enum class ButtonEventType : uint8_t
+{
+    kPress,         // button became pressed
+    kRelease,       // button became released
+    kLongPress,     // button held longer than long press time
+    kCombo          // all buttons of registered combo became pressed
+};
+
+// Single timestamped button event
+struct ButtonEvent
+{
+    uint32_t time_us;       // micros() when event was detected
+    ButtonEventType type;
+    uint8_t buttons;        // button mask (single bit, or combo mask)
+};
+
+// Debounces packed button mask and produces press / release / long press / combo events.
+// All buttons are debounced at once by a 2-bit vertical counter, a change is accepted
+// after 4 consecutive equal samples.
+class ButtonEvents
+{
+public:
+    ButtonEvents();
+
+    // Destructor
+    ~ButtonEvents() = default;
+
+    // Feed new raw sample
+    // @param sample: raw button mask, bit set means pressed
+    // @param now_us: sample time from micros()
+    void Update(uint8_t sample, uint32_t now_us);
+
+    // Get debounced button mask
+    uint8_t GetState() const { return state_; }
+
+    // Take oldest event from queue
+    // @return false if queue is empty
+    bool PopEvent(ButtonEvent* event);
+
+    // Register combo, kCombo event is generated when all buttons in mask are pressed
+    // @return false if no more combos can be registered
+    bool AddCombo(uint8_t mask);
+
+    // Get number of events lost because queue was full
+    uint8_t GetDroppedEvents() const { return dropped_events_; }
+
+private:
+    // Constants
+    static constexpr uint8_t kQueueSize = 8;    // must be power of two
+    static constexpr uint8_t kMaxCombos = 4;
+    static constexpr uint8_t kButtonCount = 8;
+    static constexpr uint32_t kLongPressUs = 1000000UL;
+
+    // Add event to queue, oldest events are kept when queue is full
+    void PushEvent(ButtonEventType type, uint8_t buttons, uint32_t now_us);
+
+    // Member variables
+    uint8_t state_;             // debounced state
+    uint8_t counter_low_;       // vertical counter bit 0
+    uint8_t counter_high_;      // vertical counter bit 1
+    uint8_t long_press_sent_;   // buttons which already generated long press
+    uint32_t press_time_us_[kButtonCount];
+    uint8_t combos_[kMaxCombos];
+    uint8_t combo_count_;
+    SpscRing<ButtonEvent, kQueueSize> queue_;
+    uint8_t dropped_events_;
+};
+
+#endif // BUTTON_EVENTS_H_
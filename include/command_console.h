@@ -0,0 +1,101 @@
+#ifndef COMMAND_CONSOLE_H_
+#define COMMAND_CONSOLE_H_
+
+#include <Arduino.h>
+
+// Runtime tunable parameters
+enum class ConsoleParam : uint8_t
+{
+    kPaLevel = 'P',     // nRF24 PA level (0 - 3)
+    kChannel = 'C',     // nRF24 channel (0 - 125)
+    kLoopRate = 'R',    // main loop rate (Hz)
+    kLogLevel = 'L',    // ArduinoLog level (0 - 6)
+    kTransport = 'T',   // transport policy (0 switch, 1 radio, 2 BLE, 3 both)
+    kCapture = 'K',     // raw input capture stream (0 off, 1 on)
+    kNoAck = 'N',       // nRF24 no-ACK mode with parity chunk (0 off, 1 on)
+    kTdma = 'M',        // send only in TDMA slot assigned by receiver beacons (0 off, 1 on)
+    kControllerId = 'I',// controller number within team (0 - 15), selects TDMA slot
+    kPidGain1 = '1',    // robot PID settings 1 - 4 (signed Q8), sent over BLE when link comes up
+    kPidGain2 = '2',
+    kPidGain3 = '3',
+    kPidGain4 = '4'
+};
+
+// Callbacks used by console to act on the application, context is passed back unchanged
+struct ConsoleHandlers
+{
+    bool (*get_param)(void* context, ConsoleParam param, int32_t* value);
+    bool (*set_param)(void* context, ConsoleParam param, int32_t value);
+    void (*dump_stats)(void* context, Print* out);
+    void (*start_calibration)(void* context);
+    bool (*save_settings)(void* context);
+    void* context;
+};
+
+// Non-blocking command parser on a serial stream.
+// Text form, one command per line:
+//   get <param>, set <param> <value>, stats, cal, save, help
+//   param: pa, ch, rate, log, tx, cap, noack, tdma, id, pid1, pid2, pid3, pid4
+// Binary form for scripts, 6 byte frame:
+//   0xA5, command ('G', 'S', 'T', 'C', 'W'), param, value (int16 LE), xor of bytes 1-4
+//   response echoes the frame with the command's highest bit set on error
+class CommandConsole
+{
+public:
+    // @param serial: stream used for commands and responses
+    // @param handlers: application callbacks, missing ones report an error
+    CommandConsole(Stream* serial, const ConsoleHandlers& handlers);
+
+    // Destructor
+    ~CommandConsole() = default;
+
+    // Process all received bytes, never waits for more
+    void Poll();
+
+    // Suppress responses while stream carries other data (e.g. capture records).
+    // Response of the command which unmutes the console is still sent, so "set cap 0" is confirmed.
+    void SetMuted(bool muted) { is_muted_ = muted; }
+    bool IsMuted() const { return is_muted_; }
+
+private:
+    // Constants
+    static constexpr size_t kLineBufferSize = 32;
+    static constexpr uint8_t kBinarySync = 0xA5;
+    static constexpr size_t kBinaryFrameSize = 6;
+    static constexpr uint8_t kBinaryErrorFlag = 0x80;
+    static constexpr uint32_t kBinaryFrameTimeoutMs = 50;   // incomplete frame is dropped after this time
+
+    // Handle single received byte
+    void ProcessByte(uint8_t byte);
+
+    // Execute complete text line
+    void ProcessLine();
+
+    // Execute complete binary frame
+    void ProcessBinaryFrame();
+
+    // Execute command shared by text and binary form
+    bool Execute(char command, ConsoleParam param, int32_t* value);
+
+    // Translate text parameter name to ConsoleParam
+    static bool ParseParam(const char* name, ConsoleParam* param);
+
+    // Print text response for parameter
+    void PrintParam(ConsoleParam param, int32_t value);
+
+    // Check if response may be sent, muted_before is the state before command was executed
+    bool CanRespond(bool muted_before) const { return !muted_before || !is_muted_; }
+
+    // Member variables
+    Stream* serial_;
+    ConsoleHandlers handlers_;
+    char line_[kLineBufferSize];
+    uint8_t line_length_;
+    bool line_overflow_;
+    uint8_t frame_[kBinaryFrameSize];
+    uint8_t frame_length_;
+    uint32_t frame_start_ms_;
+    bool is_muted_;
+};
+
+#endif // COMMAND_CONSOLE_H_
@@ -1,8 +1,45 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <stdint.h>
+
 // General configuration
 constexpr auto kMainLoopCycleTimeUs = 10000UL;      // Constant time between next main loop iteration in us (10 ms = 100 Hz)
 constexpr auto kSerialBaudRate = 250000;            // Serial communication baud rate
+constexpr uint16_t kMinLoopRateHz = 1;              // Lowest main loop rate accepted at runtime
+constexpr uint16_t kMaxLoopRateHz = 500;            // Highest main loop rate accepted at runtime
+
+// Transport configuration
+constexpr auto kBleMinFrameIntervalUs = 50000UL;    // BLE frame rate limit (20 Hz), 38400 baud link can not keep up with main loop
+
+// Robot PID configuration
+constexpr uint8_t kPidGainCount = 4;                // PID settings 1 - 4 of robot protocol, sent as one batch over BLE
+
+// TDMA configuration
+constexpr auto kTdmaBeaconGuardUs = 300UL;          // Start listening for beacon this long before it is expected
+constexpr auto kTdmaAcquireWindowUs = 5000UL;       // Listen window per tick while clock is not locked to beacons
+constexpr auto kTdmaAcquireTickDivider = 4UL;       // Listen window takes at most this fraction of tick period (1/4)
+constexpr int8_t kMaxControllerId = 15;             // Highest controller id within team, TDMA slot needs id below ids per pipe of beacon
+
+// Telemetry configuration
+constexpr uint16_t kRobotBatteryLowMv = 7000;       // Blink status LED when robot battery is below this voltage
+constexpr auto kStatusLedBlinkPeriodMs = 250UL;     // Status LED blink half period
+
+// Power configuration
+constexpr auto kRadioPowerDownMinIdleUs = 50000UL;  // Power down radio between ticks only if tick is longer (power up takes up to 5 ms)
+
+// Battery configuration
+constexpr auto kBatteryAdcReferenceMv = 5000UL;     // ADC reference voltage in mV
+constexpr auto kBatteryDividerRatio = 1UL;          // Voltage divider ratio between battery and monitor pin
+constexpr auto kBatterySamplePeriodMs = 1000UL;     // Time between battery voltage samples (1 Hz)
+constexpr auto kBatteryRateWindowMs = 60000UL;      // Window used to estimate discharge rate
+constexpr uint16_t kBatteryDisconnectedMv = 800;    // Below this voltage battery is treated as not connected
+constexpr uint16_t kBatteryLowMv = 3600;            // Enter low battery state (reduced TX rate)
+constexpr uint16_t kBatteryCriticalMv = 3500;       // Enter critical battery state (reduced PA, BLE off)
+constexpr uint16_t kBatteryDyingMv = 3400;          // Send final frame and stop transmitting
+constexpr uint16_t kBatteryHysteresisMv = 100;      // Voltage rise required to leave degraded state
+constexpr auto kLowBatteryLoopCycleTimeUs = 20000UL;    // Main loop tick in low battery state (50 Hz)
+constexpr auto kShutdownLoopCycleTimeUs = 1000000UL;    // Main loop tick after controller shut down
+constexpr auto kDyingFrameRepeatCount = 3;          // Number of times final frame is sent
 
 #endif // CONFIG_H
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Bluepad32_data_struct.h"
+
+// Number of controllers served by one receiver, each one uses its own reading pipe.
+// Transmitter builds keep the default, receiver builds may raise it up to 5.
+#ifndef CONTROLLER_TABLE_SIZE
+#define CONTROLLER_TABLE_SIZE 1
+#endif
+
+namespace BP32Data
+{
+constexpr uint8_t kMaxControllers = CONTROLLER_TABLE_SIZE;
+static_assert(kMaxControllers >= 1 && kMaxControllers <= 5, "nRF24 has 5 reading pipes besides pipe 0");
+
+// Failsafe of controller slot: without frames for timeout_ms the slot publishes neutral data,
+// it is left only after recovery_frames consecutive frames each within timeout_ms of the previous one
+struct FailsafeConfig
+{
+    uint32_t timeout_ms;
+    uint8_t recovery_frames;
+};
+constexpr FailsafeConfig kDefaultFailsafeConfig = {250, 3};
+
+// Latest complete frame of every controller with time when it was received
+class ControllerTable
+{
+public:
+    ControllerTable();
+    ~ControllerTable() = default;
+
+    // store complete frame received from controller slot
+    // @return true if frame was published, false while slot is recovering from failsafe
+    bool update(uint8_t slot, const PackedControllerData &data, uint32_t now_ms);
+    // enter failsafe in slots which timed out, neutral data is published on entry
+    // @return mask of slots which entered failsafe during this call
+    uint8_t updateFailsafe(uint32_t now_ms);
+    // check if slot publishes neutral data, slots start in failsafe until recovered
+    bool isFailsafe(uint8_t slot) const;
+    // set failsafe timeouts, applies to all slots
+    void setFailsafeConfig(const FailsafeConfig &config);
+    const FailsafeConfig& getFailsafeConfig() const { return failsafe_config_; }
+    // get latest published state of controller slot, neutral data while in failsafe
+    // @return nullptr if slot is invalid or no frame was received yet
+    const ControllerDataManager* get(uint8_t slot) const;
+    // call callback whenever one of fields of controller slot changes, including failsafe transitions
+    // @return false if slot is invalid or all subscriptions of slot are used
+    bool subscribe(uint8_t slot, uint16_t fields, ControllerChangeCallback callback, void *context);
+    // get time of latest frame of controller slot
+    uint32_t lastSeenMs(uint8_t slot) const;
+    // check if controller slot received frame within timeout
+    bool isActive(uint8_t slot, uint32_t now_ms, uint32_t timeout_ms) const;
+    // get mask of slots which received at least one frame
+    uint8_t seenMask() const { return seen_mask_; }
+
+private:
+    ControllerDataManager controllers_[kMaxControllers];
+    uint32_t last_seen_ms_[kMaxControllers];
+    uint8_t seen_mask_;
+    uint8_t failsafe_mask_;                         // slots publishing neutral data
+    uint8_t recovery_count_[kMaxControllers];       // consecutive frames received in failsafe
+    FailsafeConfig failsafe_config_;
+};
+}   // namespace BP32Data
@@ -7,26 +7,15 @@
 #include "log.h"
 #include "joystick_shield_struct.h"
 #include "Bluepad32_data_struct.h"
+#include "input_mapping.h"
 
-inline void convertGamepadDataToBP32(BP32Data::PackedControllerData &data, const PadData& pad_data) {
-    // clear data structure
-    memset(&data, 0, sizeof(BP32Data::PackedControllerData));
-    // Map joystick data to BP32 data structure
+// Map pad data to BP32 data structure with selected input mapping profile.
+// Fields which are not produced by the shield (gyro, accel) are left untouched.
+inline void convertGamepadDataToBP32(BP32Data::PackedControllerData &data, const PadData& pad_data,
+                                     InputMapping::ProfileId profile = InputMapping::ProfileId::kArcade) {
     data.id = 0;  // Assuming single controller with ID 0
     data.dpad = 0; // D-pad not used
-    data.axis_x = pad_data.joystick.x_calibrated;
-    data.axis_y = pad_data.joystick.y_calibrated;
-
-    data.buttons =
-        (pad_data.buttons.button_a        ? BP32Data::ControllerButtonConst::kButtonA     : 0) |
-        (pad_data.buttons.button_b        ? BP32Data::ControllerButtonConst::kButtonB     : 0) |
-        (pad_data.buttons.button_c        ? BP32Data::ControllerButtonConst::kButtonX     : 0) | // Map C to X
-        (pad_data.buttons.button_d        ? BP32Data::ControllerButtonConst::kButtonY     : 0) | // Map D to Y
-        (pad_data.buttons.joystick_button ? BP32Data::ControllerButtonConst::kButtonThumbL: 0);  // Map joystick button to Left Thumb
-
-    data.misc_buttons =
-        (pad_data.buttons.button_e ? BP32Data::ControllerMiscConst::kButtonSelect : 0) |
-        (pad_data.buttons.button_f ? BP32Data::ControllerMiscConst::kButtonStart  : 0);
+    InputMapping::applyProfile(profile, data, pad_data);
 }
 inline void dump_bluepad_driver_data(const BP32Data::PackedControllerData & data) {
     if (data.id != -1) {
@@ -0,0 +1,75 @@
+/*
+    Compile-time hardware abstraction for GPIO, ADC and radio pins.
+    Pins are types, so every access is resolved by the compiler to a fixed
+    register and bit (or a direct core call) without runtime dispatch.
+
+    Backend is selected at build time:
+      HAL_HOST              host stand-in, pin levels and ADC values are set by the test program
+      __AVR_ATmega328P__    direct port access on Arduino Uno / Nano
+      otherwise             Arduino core calls, for faster boards (RP2040, STM32, ...)
+
+    Every backend provides in namespace Hal:
+      template <typename P> void inputPullup();
+      template <typename P> void output();
+      template <typename P> bool read();
+      template <typename P> void write(bool level);
+      template <typename P> uint16_t readAdc();
+      class GpioSnapshot { template <typename P> bool level() const; };
+*/
+#pragma once
+
+#include <stdint.h>
+
+namespace Hal
+{
+// GPIO or analog pin in numbering of board core
+template <uint8_t N>
+struct Pin {
+    static constexpr uint8_t kNumber = N;
+};
+
+// Radio module control pins, SPI pins are given by the board core
+template <typename Ce, typename Csn>
+struct RadioPins {
+    using CePin = Ce;
+    using CsnPin = Csn;
+};
+}   // namespace Hal
+
+#if defined(HAL_HOST)
+#include "hal_host.h"
+#elif defined(__AVR_ATmega328P__)
+#include "hal_avr.h"
+#else
+#include "hal_arduino.h"
+#endif
+
+namespace Hal
+{
+namespace Detail
+{
+template <typename... Pins>
+struct PinMask;
+
+template <>
+struct PinMask<> {
+    static uint8_t read(const GpioSnapshot &, uint8_t) { return 0; }
+};
+
+template <typename P, typename... Rest>
+struct PinMask<P, Rest...> {
+    static uint8_t read(const GpioSnapshot &snapshot, uint8_t bit) {
+        return (snapshot.template level<P>() ? bit : 0) |
+               PinMask<Rest...>::read(snapshot, static_cast<uint8_t>(bit << 1));
+    }
+};
+}   // namespace Detail
+
+// Sample all pins at once, bit i of result is level of i-th pin
+template <typename... Pins>
+inline uint8_t readMask() {
+    static_assert(sizeof...(Pins) <= 8, "At most 8 pins fit into mask");
+    const GpioSnapshot snapshot;
+    return Detail::PinMask<Pins...>::read(snapshot, 1);
+}
+}   // namespace Hal
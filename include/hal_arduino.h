@@ -0,0 +1,46 @@
+/*
+    Generic Arduino core backend of hal.h for boards without direct port backend
+    (RP2040, STM32, ...). Their cores are fast enough that digitalRead is not the bottleneck.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+namespace Hal
+{
+template <typename P>
+inline void inputPullup() {
+    pinMode(P::kNumber, INPUT_PULLUP);
+}
+
+template <typename P>
+inline void output() {
+    pinMode(P::kNumber, OUTPUT);
+}
+
+template <typename P>
+inline bool read() {
+    return digitalRead(P::kNumber) == HIGH;
+}
+
+template <typename P>
+inline void write(bool level) {
+    digitalWrite(P::kNumber, level ? HIGH : LOW);
+}
+
+// Result is scaled to 10 bits like on AVR, so calibration and mapping stay the same
+template <typename P>
+inline uint16_t readAdc() {
+    return analogRead(P::kNumber);
+}
+
+// Pins are read one by one when mask is built
+class GpioSnapshot
+{
+public:
+    GpioSnapshot() {}
+
+    template <typename P>
+    bool level() const { return read<P>(); }
+};
+}   // namespace Hal
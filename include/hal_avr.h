@@ -0,0 +1,91 @@
+/*
+    ATmega328P backend of hal.h, Uno pin numbering:
+    0..7 port D, 8..13 port B, 14..19 (A0..A5) port C.
+    Constant port and bit let the compiler emit single sbi / cbi / sbis instructions.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+namespace Hal
+{
+namespace Avr
+{
+enum Port : uint8_t { kPortB, kPortC, kPortD };
+
+constexpr Port portOf(uint8_t pin) {
+    return pin < 8 ? kPortD : (pin < 14 ? kPortB : kPortC);
+}
+constexpr uint8_t bitOf(uint8_t pin) {
+    return static_cast<uint8_t>(1U << (pin < 8 ? pin : (pin < 14 ? pin - 8 : pin - 14)));
+}
+
+inline volatile uint8_t& pinRegister(Port port) {
+    return port == kPortB ? PINB : (port == kPortC ? PINC : PIND);
+}
+inline volatile uint8_t& ddrRegister(Port port) {
+    return port == kPortB ? DDRB : (port == kPortC ? DDRC : DDRD);
+}
+inline volatile uint8_t& portRegister(Port port) {
+    return port == kPortB ? PORTB : (port == kPortC ? PORTC : PORTD);
+}
+
+template <typename P>
+struct Traits {
+    static_assert(P::kNumber < 20, "Pin does not exist on ATmega328P");
+    static constexpr Port kPort = portOf(P::kNumber);
+    static constexpr uint8_t kBit = bitOf(P::kNumber);
+};
+}   // namespace Avr
+
+template <typename P>
+inline void inputPullup() {
+    Avr::ddrRegister(Avr::Traits<P>::kPort) &= ~Avr::Traits<P>::kBit;
+    Avr::portRegister(Avr::Traits<P>::kPort) |= Avr::Traits<P>::kBit;
+}
+
+template <typename P>
+inline void output() {
+    Avr::ddrRegister(Avr::Traits<P>::kPort) |= Avr::Traits<P>::kBit;
+}
+
+template <typename P>
+inline bool read() {
+    return Avr::pinRegister(Avr::Traits<P>::kPort) & Avr::Traits<P>::kBit;
+}
+
+template <typename P>
+inline void write(bool level) {
+    if (level) {
+        Avr::portRegister(Avr::Traits<P>::kPort) |= Avr::Traits<P>::kBit;
+    } else {
+        Avr::portRegister(Avr::Traits<P>::kPort) &= ~Avr::Traits<P>::kBit;
+    }
+}
+
+// Conversion takes ~112 us at default prescaler, core handles mux and reference
+template <typename P>
+inline uint16_t readAdc() {
+    static_assert(P::kNumber >= A0 && P::kNumber <= A5, "Pin has no ADC channel");
+    return analogRead(P::kNumber);
+}
+
+// All three ports are latched within three cycles
+class GpioSnapshot
+{
+public:
+    GpioSnapshot(): port_b_(PINB), port_c_(PINC), port_d_(PIND) {}
+
+    template <typename P>
+    bool level() const {
+        const uint8_t port = Avr::Traits<P>::kPort == Avr::kPortB ? port_b_ :
+                             (Avr::Traits<P>::kPort == Avr::kPortC ? port_c_ : port_d_);
+        return port & Avr::Traits<P>::kBit;
+    }
+
+private:
+    uint8_t port_b_;
+    uint8_t port_c_;
+    uint8_t port_d_;
+};
+}   // namespace Hal
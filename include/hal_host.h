@@ -0,0 +1,62 @@
+/*
+    Host backend of hal.h, used when firmware code runs in a host program.
+    Inputs are scripted through Hal::Host::state(), outputs can be checked there.
+*/
+#pragma once
+
+#include <stdint.h>
+#include "hal_host_state.h"
+
+namespace Hal
+{
+namespace Host
+{
+template <typename P>
+struct Traits {
+    static_assert(P::kNumber < kPinCount, "Host backend supports pins 0..31");
+    static constexpr uint32_t kBit = 1UL << P::kNumber;
+};
+}   // namespace Host
+
+template <typename P>
+inline void inputPullup() {
+    Host::state().outputs &= ~Host::Traits<P>::kBit;
+    Host::state().pullups |= Host::Traits<P>::kBit;
+}
+
+template <typename P>
+inline void output() {
+    Host::state().outputs |= Host::Traits<P>::kBit;
+}
+
+template <typename P>
+inline bool read() {
+    return Host::state().levels & Host::Traits<P>::kBit;
+}
+
+template <typename P>
+inline void write(bool level) {
+    if (level) {
+        Host::state().levels |= Host::Traits<P>::kBit;
+    } else {
+        Host::state().levels &= ~Host::Traits<P>::kBit;
+    }
+}
+
+template <typename P>
+inline uint16_t readAdc() {
+    return Host::state().adc[P::kNumber & (Host::kPinCount - 1)];
+}
+
+class GpioSnapshot
+{
+public:
+    GpioSnapshot(): levels_(Host::state().levels) {}
+
+    template <typename P>
+    bool level() const { return levels_ & Host::Traits<P>::kBit; }
+
+private:
+    uint32_t levels_;
+};
+}   // namespace Hal
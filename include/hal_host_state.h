@@ -0,0 +1,27 @@
+/*
+    Pin levels, pin modes and ADC values of a host program. Read by the host backend of hal.h
+    and by the Arduino core stand-in, so both HAL backends can run against the same script.
+*/
+#pragma once
+
+#include <stdint.h>
+
+namespace Hal
+{
+namespace Host
+{
+constexpr uint8_t kPinCount = 32;
+
+struct State {
+    uint32_t levels;            // input level of every pin, set by test program
+    uint32_t outputs;           // pins configured as output
+    uint32_t pullups;           // pins configured as input with pull-up
+    uint16_t adc[kPinCount];    // conversion result of every pin
+};
+
+inline State& state() {
+    static State host_state = {0xFFFFFFFFUL, 0, 0, {}};
+    return host_state;
+}
+}   // namespace Host
+}   // namespace Hal
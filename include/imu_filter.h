@@ -0,0 +1,49 @@
+/*
+    Fixed-point complementary filter for 6-axis IMU.
+    Estimated gravity vector is rotated with gyro rates every step and pulled
+    towards measured acceleration, so no trigonometry or floats are needed.
+    Code has no hardware dependencies and can be fed with recorded samples.
+*/
+#pragma once
+
+#include <stdint.h>
+
+namespace Imu
+{
+// Raw sensor counts, MPU-6050 configured to +-4 G and +-500 deg/s
+struct RawSample {
+    int16_t accel[3];
+    int16_t gyro[3];
+};
+
+constexpr int32_t kAccelCountsPerG = 8192;      // +-4 G range
+constexpr int32_t kGyroCountsPerDps10 = 655;    // +-500 deg/s range, counts per 10 deg/s
+
+class ComplementaryFilter
+{
+public:
+    ComplementaryFilter();
+
+    // Start estimation from measured acceleration
+    void reset(const RawSample &sample);
+    // Integrate gyro over dt_us and fuse with measured acceleration
+    void update(const RawSample &sample, uint32_t dt_us);
+
+    // Estimated gravity vector in milli-G (body frame)
+    int32_t gravityMg(uint8_t axis) const { return gravity_q_[axis] >> kGravityShift; }
+    // Angular rate in deg/s
+    int32_t rateDps(uint8_t axis) const { return rate_dps_[axis]; }
+    // Check if filter was initialized with first sample
+    bool isInitialized() const { return is_initialized_; }
+
+private:
+    static constexpr uint8_t kGravityShift = 4;     // extra fractional bits of gravity estimate
+    static constexpr uint8_t kFusionShift = 6;      // accelerometer weight 1/64 per step (alpha ~0.98)
+    static constexpr uint32_t kMaxStepUs = 20000;   // longer steps are clamped to keep int32 math in range
+
+    int32_t gravity_q_[3];  // milli-G << kGravityShift
+    int32_t rate_dps_[3];
+    bool is_initialized_;
+};
+
+}   // namespace Imu
@@ -0,0 +1,59 @@
+#ifndef IMU_MPU6050_H_
+#define IMU_MPU6050_H_
+
+#include <Arduino.h>
+#include "imu_filter.h"
+
+// MPU-6050 driver using interrupt driven I2C (TWI) transactions.
+// Burst read of all sensor registers runs in background between loop ticks,
+// so the loop never waits for the bus. Replaces Wire, do not use both.
+class ImuMpu6050
+{
+public:
+    // @param address: 7-bit I2C address (0x68 with AD0 low, 0x69 with AD0 high)
+    explicit ImuMpu6050(uint8_t address = kDefaultAddress);
+
+    // Destructor
+    ~ImuMpu6050() = default;
+
+    // Configure bus and sensor, blocks for a few ms at boot
+    // @return false if sensor does not respond
+    bool Initialize();
+
+    // Start background read of next sample, ignored while previous read is in progress
+    bool StartRead();
+
+    // Take sample of last finished read
+    // @return false if there is no new sample
+    bool GetSample(Imu::RawSample* sample);
+
+    // Check if sensor was initialized
+    bool IsInitialized() const { return is_initialized_; }
+
+    // Get number of failed bus transactions
+    uint16_t GetErrorCount() const;
+
+private:
+    // Constants
+    static constexpr uint8_t kDefaultAddress = 0x68;
+    static constexpr uint8_t kRegisterWhoAmI = 0x75;
+    static constexpr uint8_t kRegisterPowerManagement = 0x6B;
+    static constexpr uint8_t kRegisterConfig = 0x1A;
+    static constexpr uint8_t kRegisterGyroConfig = 0x1B;
+    static constexpr uint8_t kRegisterAccelConfig = 0x1C;
+    static constexpr uint8_t kRegisterAccelX = 0x3B;
+    static constexpr uint8_t kSampleRegisterCount = 14;     // accel, temperature, gyro
+    static constexpr uint32_t kTransactionTimeoutMs = 5;
+
+    // Write single register and wait until transaction ends
+    bool WriteRegisterBlocking(uint8_t reg, uint8_t value);
+
+    // Read registers and wait until transaction ends
+    bool ReadRegistersBlocking(uint8_t reg, uint8_t* buffer, uint8_t length);
+
+    // Member variables
+    uint8_t address_;
+    bool is_initialized_;
+};
+
+#endif // IMU_MPU6050_H_
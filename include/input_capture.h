@@ -0,0 +1,57 @@
+#ifndef INPUT_CAPTURE_H_
+#define INPUT_CAPTURE_H_
+
+#include <Arduino.h>
+#include "joystick_shield_struct.h"
+
+// Raw input sample as stored in capture stream
+struct CaptureRecord
+{
+    uint32_t time_us;   // micros() when inputs were read
+    uint16_t x_raw;     // joystick X ADC value (0 - 1023)
+    uint16_t y_raw;     // joystick Y ADC value (0 - 1023)
+    uint8_t buttons;    // raw (not debounced) button mask, ButtonMask bit order
+};
+
+// Streams timestamped raw inputs as compact binary records, so a session can be
+// replayed through ApplyJoystickCalibration and the rest of the pipeline later.
+// Record, 10 bytes:
+//   0xCA, time_us (uint32 LE), x | y << 10 | buttons << 20 (uint32 LE), xor of bytes 1-8
+class InputCapture
+{
+public:
+    static constexpr uint8_t kRecordSync = 0xCA;
+    static constexpr size_t kRecordSize = 10;
+
+    // @param out: stream for records, log output should be silenced while capture is active
+    explicit InputCapture(Print* out);
+
+    // Destructor
+    ~InputCapture() = default;
+
+    // Start or stop streaming records, counters are reset on start
+    void Start();
+    void Stop();
+    bool IsActive() const { return is_active_; }
+
+    // Write record if capture is active, never blocks
+    // @return false if record was dropped because output buffer is full
+    bool Write(uint32_t time_us, const JoystickData& joystick, uint8_t buttons);
+
+    // Get number of written and dropped records since start
+    uint32_t GetRecordCount() const { return record_count_; }
+    uint16_t GetDroppedCount() const { return dropped_count_; }
+
+    // Encode and decode single record, shared with replay tools
+    static void Encode(const CaptureRecord& record, uint8_t (&buffer)[kRecordSize]);
+    static bool Decode(const uint8_t (&buffer)[kRecordSize], CaptureRecord* record);
+
+private:
+    // Member variables
+    Print* out_;
+    uint32_t record_count_;
+    uint16_t dropped_count_;
+    bool is_active_;
+};
+
+#endif // INPUT_CAPTURE_H_
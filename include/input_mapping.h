@@ -0,0 +1,152 @@
+/*
+    Declarative mapping of physical shield inputs to logical BP32 controller outputs.
+    Profiles are constexpr tables, each profile is instantiated as its own function,
+    so table values become immediates and no table is kept in SRAM.
+*/
+#pragma once
+
+#include <stdint.h>
+
+#include "joystick_shield_struct.h"
+#include "Bluepad32_data_struct.h"
+
+namespace InputMapping
+{
+// Selectable mapping profiles
+enum class ProfileId : uint8_t {
+    kArcade,    // joystick drives left stick, legacy button layout
+    kTank,      // joystick mixed into left / right track on both Y axes
+    kCamera,    // joystick drives right stick at half rate, Y inverted
+    kCount
+};
+
+// Logical axis outputs of PackedControllerData
+enum AxisOutput : uint8_t {
+    kAxisX,
+    kAxisY,
+    kAxisRX,
+    kAxisRY,
+    kBrake,
+    kThrottle,
+    kAxisOutputCount
+};
+
+// Fixed-point gain, kUnityGain means 1.0, negative gain inverts the input
+constexpr uint8_t kGainShift = 8;
+constexpr int16_t kUnityGain = 1 << kGainShift;
+constexpr int16_t kAxisMin = -512;
+constexpr int16_t kAxisMax = 512;
+constexpr int16_t kPedalMin = 0;
+constexpr int16_t kPedalMax = 1023;
+
+// output = clamp(((x * gain_x + y * gain_y) >> kGainShift) + offset, min, max)
+struct AxisRule {
+    int16_t gain_x;
+    int16_t gain_y;
+    int16_t offset;
+    int16_t min;
+    int16_t max;
+};
+
+// Physical buttons in ButtonMask bit order: A, B, C, D, E, F, joystick
+struct ButtonRule {
+    uint16_t buttons;       // BP32 buttons set when physical button is pressed
+    uint8_t misc_buttons;   // BP32 misc buttons set when physical button is pressed
+};
+
+struct Profile {
+    AxisRule axes[kAxisOutputCount];
+    ButtonRule buttons[ButtonMask::kButtonCount];
+};
+
+namespace Rule
+{
+constexpr AxisRule kUnused = {0, 0, 0, 0, 0};
+constexpr AxisRule axis(int16_t gain_x, int16_t gain_y) {
+    return AxisRule{gain_x, gain_y, 0, kAxisMin, kAxisMax};
+}
+constexpr ButtonRule button(uint16_t buttons) {
+    return ButtonRule{buttons, 0};
+}
+constexpr ButtonRule misc(uint8_t misc_buttons) {
+    return ButtonRule{0, misc_buttons};
+}
+}   // namespace Rule
+
+namespace Profiles
+{
+using namespace BP32Data::ControllerButtonConst;
+using namespace BP32Data::ControllerMiscConst;
+
+constexpr Profile kArcade = {
+    {
+        Rule::axis(kUnityGain, 0),      // axis_x
+        Rule::axis(0, kUnityGain),      // axis_y
+        Rule::kUnused,                  // axis_rx
+        Rule::kUnused,                  // axis_ry
+        Rule::kUnused,                  // brake
+        Rule::kUnused,                  // throttle
+    },
+    {
+        Rule::button(kButtonA),
+        Rule::button(kButtonB),
+        Rule::button(kButtonX),         // C
+        Rule::button(kButtonY),         // D
+        Rule::misc(kButtonSelect),      // E
+        Rule::misc(kButtonStart),       // F
+        Rule::button(kButtonThumbL),    // joystick button
+    }
+};
+
+constexpr Profile kTank = {
+    {
+        Rule::kUnused,
+        Rule::axis(kUnityGain, kUnityGain),     // left track = y + x
+        Rule::kUnused,
+        Rule::axis(-kUnityGain, kUnityGain),    // right track = y - x
+        Rule::kUnused,
+        Rule::kUnused,
+    },
+    {
+        Rule::button(kButtonA),
+        Rule::button(kButtonB),
+        Rule::button(kButtonX),
+        Rule::button(kButtonY),
+        Rule::misc(kButtonSelect),
+        Rule::misc(kButtonStart),
+        Rule::button(kButtonThumbL),
+    }
+};
+
+constexpr Profile kCamera = {
+    {
+        Rule::kUnused,
+        Rule::kUnused,
+        Rule::axis(kUnityGain / 2, 0),  // pan
+        Rule::axis(0, -kUnityGain / 2), // tilt, inverted
+        Rule::kUnused,
+        Rule::kUnused,
+    },
+    {
+        Rule::button(kButtonShoulderL), // A zoom out
+        Rule::button(kButtonShoulderR), // B zoom in
+        Rule::button(kButtonX),
+        Rule::button(kButtonY),
+        Rule::misc(kButtonSelect),
+        Rule::misc(kButtonStart),
+        Rule::button(kButtonThumbR),    // joystick button centers camera
+    }
+};
+}   // namespace Profiles
+
+// Map pad data to controller data with selected profile.
+// Only mapped fields are written, other fields (id, gyro, accel) are left untouched.
+void applyProfile(ProfileId profile, BP32Data::PackedControllerData &data, const PadData &pad_data);
+
+// Get next profile, wraps around to first one
+ProfileId nextProfile(ProfileId profile);
+
+// Convert profile to string for logging
+const char* profileToString(ProfileId profile);
+
+}   // namespace InputMapping
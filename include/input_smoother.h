@@ -0,0 +1,65 @@
+/*
+    Optional receiver stage between receiveGamepadData and the consumer.
+    Every frame is time stamped on arrival, axes are then either interpolated between
+    the last two frames (smooth, one frame of delay) or extrapolated from them for
+    a bounded horizon (no delay, overshoots on direction change). Fixed-point only.
+*/
+#pragma once
+
+#include <stdint.h>
+
+#include "Bluepad32_data_struct.h"
+#include "input_mapping.h"
+
+enum class AxisSmoothing : uint8_t {
+    kNone,          // latest received value, step at transmit rate
+    kInterpolate,   // between previous and latest frame, delayed by one frame interval
+    kExtrapolate    // latest value continued with last slope, up to horizon
+};
+
+struct SmoothingConfig {
+    AxisSmoothing axes[InputMapping::kAxisOutputCount];     // indexed by InputMapping::AxisOutput
+    uint16_t extrapolation_horizon_ms;  // extrapolation stops after this time without frame
+};
+
+constexpr SmoothingConfig kDefaultSmoothingConfig = {
+    {
+        AxisSmoothing::kExtrapolate,    // axis_x
+        AxisSmoothing::kExtrapolate,    // axis_y
+        AxisSmoothing::kExtrapolate,    // axis_rx
+        AxisSmoothing::kExtrapolate,    // axis_ry
+        AxisSmoothing::kNone,           // brake
+        AxisSmoothing::kNone,           // throttle
+    },
+    50
+};
+
+class InputSmoother
+{
+public:
+    explicit InputSmoother(const SmoothingConfig &config = kDefaultSmoothingConfig);
+    ~InputSmoother() = default;
+
+    // store frame received at now_ms, neutral frame (id -1) and the frame after it clear history
+    void addFrame(const BP32Data::PackedControllerData &data, uint32_t now_ms);
+    // get latest frame with smoothed axes for consumer time now_ms
+    // @return false if no frame was added yet
+    bool sample(uint32_t now_ms, BP32Data::PackedControllerData &data) const;
+    // change smoothing of all axes
+    void setConfig(const SmoothingConfig &config);
+    const SmoothingConfig& getConfig() const { return config_; }
+
+private:
+    static constexpr uint8_t kFractionShift = 8;    // Q8 position between frames
+
+    int32_t smoothAxis(uint8_t axis, uint32_t now_ms) const;
+    // drop history, data becomes the only frame
+    void restartHistory(const BP32Data::PackedControllerData &data, uint32_t now_ms);
+
+    SmoothingConfig config_;
+    BP32Data::PackedControllerData previous_;
+    BP32Data::PackedControllerData latest_;
+    uint32_t previous_time_ms_;
+    uint32_t latest_time_ms_;
+    uint8_t frame_count_;   // saturates at 2, interpolation needs two frames
+};
@@ -10,9 +10,18 @@
 
 // Function declarations
 void JoystickShieldSetup();
-void CalibrateJoystick(CalibrationData* cal_data);
+void StartCenterCalibration(CenterCalibration* calibration);
+bool UpdateCenterCalibration(CenterCalibration* calibration, const JoystickData* data, CalibrationData* cal_data);
+bool CheckCalibrationCombo(CalibrationSweep* sweep, const ButtonStates* states);
+void StartCalibrationSweep(CalibrationSweep* sweep, const JoystickData* data);
+bool UpdateCalibrationSweep(CalibrationSweep* sweep, const JoystickData* data);
+bool FinishCalibrationSweep(CalibrationSweep* sweep, CalibrationData* cal_data);
 void ReadJoystickData(JoystickData* data, const CalibrationData* cal_data = nullptr);
+void ApplyJoystickCalibration(JoystickData* data, const CalibrationData* cal_data = nullptr);
+uint8_t ReadButtonMask();
 void ReadButtonStates(ButtonStates* states);
+uint8_t PackButtonStates(const ButtonStates* states);
+void UnpackButtonStates(uint8_t mask, ButtonStates* states);
 JoystickDirection GetJoystickDirection(int analog_value, int center_value, bool is_vertical = false);
 const char* DirectionToString(JoystickDirection direction);
 void PrintActiveButtons(const ButtonStates* states);
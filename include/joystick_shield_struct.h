@@ -6,6 +6,8 @@
 #ifndef JOYSTICK_SHIELD_STRUCT_H
 #define JOYSTICK_SHIELD_STRUCT_H
 
+#include <stdint.h>
+
 // Direction enumeration
 enum class JoystickDirection {
     kLeft,
@@ -26,6 +28,22 @@ struct CalibrationData {
     bool calibrated;
 };
 
+// Full range calibration sweep state
+struct CalibrationSweep {
+    CalibrationData data;           // ranges learned during sweep
+    uint32_t start_ms;              // time when sweep started
+    uint32_t combo_since_ms;        // time when calibration combo was pressed, 0 if released
+    bool combo_handled;             // combo already triggered, wait for release
+    bool active;                    // sweep in progress
+};
+
+// Center calibration spread over scheduled loop ticks, so boot does not wait for it
+struct CenterCalibration {
+    long x_sum;
+    long y_sum;
+    unsigned int samples;
+};
+
 // Button state structure
 struct ButtonStates {
     bool button_a;
@@ -37,6 +55,18 @@ struct ButtonStates {
     bool joystick_button;
 };
 
+// Bit positions of buttons in packed button mask
+namespace ButtonMask {
+    constexpr uint8_t kButtonA = 0x01;
+    constexpr uint8_t kButtonB = 0x02;
+    constexpr uint8_t kButtonC = 0x04;
+    constexpr uint8_t kButtonD = 0x08;
+    constexpr uint8_t kButtonE = 0x10;
+    constexpr uint8_t kButtonF = 0x20;
+    constexpr uint8_t kJoystickButton = 0x40;
+    constexpr uint8_t kButtonCount = 7;
+}
+
 // Joystick data structure
 struct JoystickData {
     int x_raw;
@@ -0,0 +1,26 @@
+#ifndef MEMORY_DIAGNOSTICS_H_
+#define MEMORY_DIAGNOSTICS_H_
+
+#include <Arduino.h>
+
+// SRAM usage of ATmega328P: free space between heap and stack, stack high-water mark
+// from stack painted with a pattern before startup code runs, and heap fragmentation.
+// All values are 0 on targets other than AVR.
+namespace MemoryDiagnostics
+{
+struct Report {
+    uint16_t static_ram;        // .data and .bss
+    uint16_t free_now;          // gap between heap end and stack pointer
+    uint16_t stack_unused;      // painted bytes never touched by stack or heap, lowest free gap since boot
+    uint16_t heap_free;         // bytes in heap free list, reusable only by fitting allocations
+    uint16_t heap_largest_free; // largest single allocation possible now
+};
+
+// Collect current memory usage, scans painted area so it should not run every tick
+void GetReport(Report* report);
+
+// Print report as "name value" lines, same format as other stats
+void PrintReport(Print* out);
+}   // namespace MemoryDiagnostics
+
+#endif // MEMORY_DIAGNOSTICS_H_
@@ -3,55 +3,199 @@
 #include <Arduino.h>
 #include <RF24.h>
 #include "Bluepad32_data_struct.h"
+#include "transport.h"
+#include "controller_table.h"
+#include "tdma_schedule.h"
 
 namespace RF24Driver
 {
 constexpr byte address_rx[6] = {"PADRX"};
 constexpr byte address_tx[6] = {"PADTX"};
 
+constexpr uint8_t kDefaultPALevel = RF24_PA_LOW;
+constexpr uint8_t kDefaultChannel = 76;
+constexpr uint8_t kMaxChannel = 125;
+constexpr size_t kAddressSize = 5;
+
 constexpr size_t kMaxPayloadSize = 32;
-constexpr size_t kPackageRequiedPerPayload = sizeof(BP32Data::PackedControllerData) / kMaxPayloadSize + 1;
-constexpr size_t kPackageDataSize = 28;
+constexpr size_t kPackageHeaderSize = 4;
+constexpr size_t kPackageDataSize = kMaxPayloadSize - kPackageHeaderSize;
+constexpr size_t kPackageRequiedPerPayload = (sizeof(BP32Data::PackedControllerData) + kPackageDataSize - 1) / kPackageDataSize;
+// Sent with dynamic payload length kPackageHeaderSize + dataBytes, short chunks take less air time
 struct Package {
     uint8_t packetID;
     uint8_t chunkIndex;
     uint8_t totalChunks;
     uint8_t dataBytes;
-    uint8_t data[kPackageDataSize];  //  28-bytes payload - 6 bytes for metadata
+    uint8_t data[kPackageDataSize];  //  28-bytes payload - 4 bytes for metadata
+};
+static_assert(sizeof(Package) == kMaxPayloadSize, "Package header has to stay packed");
+
+// Robot status returned by receiver in ACK payload of controller frames
+constexpr uint8_t kTelemetryType = 0xC7;
+constexpr uint32_t kTelemetryTimeoutMs = 1000;  // telemetry older than this is treated as stale
+struct Telemetry {
+    uint8_t type;           // kTelemetryType, identifies telemetry payload
+    uint8_t mode;           // robot operating mode
+    uint16_t battery_mv;    // robot battery voltage
+    uint8_t link_quality;   // percentage of controller frames received by robot in last second
+    uint8_t reserved;
+    int16_t pid_setpoint;   // robot PID state
+    int16_t pid_error;
+    int16_t pid_output;
 };
+static_assert(sizeof(Telemetry) <= kMaxPayloadSize, "Telemetry does not fit into ACK payload");
+
+// Monotonic link counters, never reset while running
+struct LinkStats {
+    uint32_t frames_sent;       // frames with every chunk acknowledged
+    uint32_t frames_failed;     // frames with at least one lost chunk
+    uint32_t chunks_sent;       // acknowledged chunks
+    uint32_t chunks_failed;     // chunks lost after all retries (PLOS_CNT increments)
+    uint32_t retransmits;       // sum of ARC_CNT of every chunk
+    uint32_t rx_frames;         // frames fully assembled on receiver side
+    uint32_t rx_chunks_dropped; // received chunks discarded by reassembly
+    uint32_t rx_failsafe_events;// controllers which lost link and switched to neutral output
+    uint32_t rx_chunks_recovered;// lost chunks rebuilt from parity chunk
+};
+constexpr uint32_t kLinkStatsReportPeriodMs = 5000;
 
 struct PackageContainer {
     Package package;        // received data
-    size_t package_size;    // total size of package without unused payload data
+    size_t package_size;    // received payload length, header and dataBytes of data
 };
 
-class NRF24Controller
+// Frames arrive on reading pipes 1 .. kMaxControllers, pipe N belongs to controller slot N - 1
+constexpr uint8_t kFirstRxPipe = 1;
+constexpr uint8_t kMaxChunksPerPoll = 8;    // bounds time spent draining RX FIFO in one poll
+// Chunks of one frame are sent back to back, 8-bit packet ID repeats only after 256 frames,
+// so an older partial frame with the same ID belongs to a frame from before the wrap
+constexpr uint32_t kReassemblyTimeoutMs = 50;
+// In no-ACK mode each frame is followed by XOR of its data chunks, any single lost chunk is rebuilt from it
+constexpr uint8_t kParityChunkIndex = kPackageRequiedPerPayload;
+static_assert(kPackageRequiedPerPayload + 1 <= 8, "Chunk mask of reassembly holds up to 8 chunks");
+
+class NRF24Controller : public Transport
 {
 public:
     NRF24Controller(const int ce_pin, const int csn_pin);
-    ~NRF24Controller();
+    ~NRF24Controller() override;
     // initialize driver
     bool init();
     // check if driver is initialized
     bool checkDriverIsInitialized() const;
     // send gamepad data to receiver
     bool sendGamepadData(const BP32Data::PackedControllerData &data);
-    // receive gamepad data from receiver
+    // Transport interface
+    bool sendFrame(const BP32Data::PackedControllerData &data) override { return sendGamepadData(data); }
+    bool isReady() const override { return checkDriverIsInitialized(); }
+    const char* name() const override { return "NRF24"; }
+    // drain RX FIFO, reassemble frames of all controllers and check failsafe timeouts
+    // @return number of published updates, frames and failsafe entries
+    uint8_t pollControllers();
+    // drain RX FIFO, data is set to the last update published during this poll,
+    // neutral data (id -1) is published once when controller enters failsafe
+    // @return true if at least one update was published
     bool receiveGamepadData(BP32Data::PackedControllerData &data);
+    // get latest frame of every controller (receiver side)
+    const BP32Data::ControllerTable& getControllers() const;
+    // get controllers to subscribe to field changes of single controller
+    BP32Data::ControllerTable& getControllers();
+    // set failsafe timeout and recovery hysteresis of all controllers
+    void setFailsafeConfig(const BP32Data::FailsafeConfig &config);
+    // set address of reading pipe (kFirstRxPipe .. kMaxControllers),
+    // pipes other than 1 only use the first address byte, the rest is shared with pipe 1
+    bool setRxAddress(uint8_t pipe, const uint8_t (&address)[kAddressSize]);
+    // get last telemetry received in ACK payload (transmitter side)
+    // @return false if no telemetry was received within kTelemetryTimeoutMs
+    bool getTelemetry(Telemetry &telemetry) const;
+    // get link counters
+    const LinkStats& getLinkStats() const;
+    // log link summary, at most once per kLinkStatsReportPeriodMs
+    // @return true if report was logged
+    bool reportLinkStats();
+    // set telemetry attached to ACK of every received chunk (receiver side)
+    void setTelemetry(const Telemetry &telemetry);
+    // put radio in power down mode, next send wakes it up
+    void powerDown();
+    // wake up radio from power down mode
+    void powerUp();
+    // check if radio is in power down mode
+    bool isPoweredDown() const;
+    // set power amplifier level (RF24_PA_MIN .. RF24_PA_MAX)
+    bool setPALevel(uint8_t pa_level);
+    // set RF channel (0 .. kMaxChannel)
+    bool setChannel(uint8_t channel);
+    // set address of writing pipe
+    bool setTxAddress(const uint8_t (&address)[kAddressSize]);
+    // send TDMA beacon to all controllers listening on address_rx (receiver side),
+    // data slots are split evenly between reading pipes of the controller table
+    bool sendBeacon(uint8_t slot_count, uint16_t slot_us);
+    // listen for TDMA beacon and lock clock to it, busy waits at most timeout_us (controller side)
+    // @return true if beacon was received
+    bool waitForBeacon(uint32_t timeout_us);
+    // send frames only in own TDMA slot, slot is derived from pairing ID and controller id,
+    // nothing is sent while locked if they do not fit into slot layout of the receiver
+    void setTdma(bool enable, uint8_t pairing_id, int8_t controller_id);
+    // check if TDMA is enabled
+    bool isTdmaEnabled() const;
+    // get clock locked to receiver beacons
+    const Tdma::Clock& getTdmaClock() const;
+    // get own slot, valid after first beacon, Tdma::kNoSlot if there is none
+    uint8_t getTdmaSlot() const;
+    // send chunks without ACK and retries, followed by parity chunk,
+    // air time per frame is fixed but ACK payload telemetry is not received
+    void setNoAckMode(bool enable);
+    // check if chunks are sent without ACK
+    bool isNoAckMode() const;
 
 private:
     static int count;
     RF24 radio_;            // Object with single RF24 instance
     bool is_initialized_;   // flag to check if driver is initialized
+    bool is_powered_down_;  // flag to check if radio is in power down mode
+    bool is_listening_;     // flag to check if radio is in RX mode
+    bool is_no_ack_mode_;   // flag to check if chunks are sent without ACK
+    bool is_tdma_enabled_;  // flag to check if frames are sent only in own TDMA slot
+    uint8_t tdma_pairing_id_;
+    int8_t tdma_controller_id_;
+    uint8_t tdma_slot_;
+    uint8_t rx_pairing_id_;     // first address byte of reading pipe 1, base of beacon slot layout
+    Tdma::Clock tdma_clock_;
     Package packages_to_send_[kPackageRequiedPerPayload];
-    BP32Data::PackedControllerData received_data_;
-    uint16_t received_packet_id;
-    uint16_t received_chunk;
-    uint16_t received_total_chunks;
+    Telemetry telemetry_;               // last received (TX side) or queued (RX side) telemetry
+    uint32_t telemetry_time_ms_;        // time when telemetry was received
+    bool has_telemetry_;                // telemetry was received (TX side)
+    bool send_telemetry_;               // telemetry is attached to ACKs (RX side)
+    LinkStats link_stats_;
+    LinkStats reported_stats_;          // counters at time of last report
+    uint32_t report_time_ms_;           // time of last report
+    // Reassembly state of one controller, chunks may arrive in any order
+    struct Reassembly {
+        BP32Data::PackedControllerData data;
+        uint8_t parity[kPackageDataSize];   // parity chunk data, valid if its bit is set in chunk_mask
+        uint8_t packet_id;
+        uint8_t chunk_mask;     // bit per received chunk, parity chunk included
+        bool active;            // at least one chunk of packet_id was received
+        bool complete;          // frame of packet_id was published, late chunks are ignored
+        uint32_t chunk_time_ms;         // time of last accepted chunk
+    };
+    Reassembly reassembly_[BP32Data::kMaxControllers];
+    BP32Data::ControllerTable controllers_;
+    uint8_t last_published_slot_;
     inline static uint8_t packetIDCounter;
     void splitPayloadToPackages(const BP32Data::PackedControllerData &data);
-    void convertPackageToPayload(BP32Data::PackedControllerData &data, const PackageContainer &packet);
-    void resetReceivedPackages();
+    // XOR data of all chunks in packages_to_send_ into parity chunk
+    void buildParityPackage(Package &parity) const;
+    // write single chunk and update link statistics
+    bool writePackage(const Package &package);
+    // rebuild single missing data chunk from parity chunk
+    void recoverMissingChunk(Reassembly &reassembly, uint8_t missing_chunk) const;
+    // merge chunk into reassembly of its controller
+    // @return true if chunk completed the frame
+    bool convertPackageToPayload(uint8_t slot, const PackageContainer &packet, uint32_t now_ms);
+    void resetReceivedPackages(uint8_t slot);
+    void readAckPayload();
 };
 
 }   // namespace NRF24Driver
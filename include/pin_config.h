@@ -2,7 +2,39 @@
 #define PIN_CONFIG_H
 
 #include <Arduino.h>
+#include "hal.h"
 
+#if defined(ARDUINO_ARCH_RP2040)
+// Raspberry Pi Pico: SPI0 on default pins, I2C0 on GP4 / GP5, only GP26..GP28 have ADC
+
+// Joystick pin definitions
+constexpr int JOYSTICK_X_PIN = A0;          /// < Joystick X-axis analog pin (GP26)
+constexpr int JOYSTICK_Y_PIN = A1;          /// < Joystick Y-axis analog pin (GP27)
+constexpr int JOYSTICK_BUTTON_PIN = 9;      /// < Joystick center button pin
+
+// Button pin definitions
+constexpr int A_PIN = 10;                   /// < Button A pin
+constexpr int B_PIN = 11;                   /// < Button B pin
+constexpr int C_PIN = 12;                   /// < Button C pin
+constexpr int D_PIN = 13;                   /// < Button D pin
+constexpr int E_PIN = 14;                   /// < Button E pin
+constexpr int F_PIN = 15;                   /// < Button F pin
+
+constexpr int NRF24L01_CE_PIN   = 20;       /// < nRF24L01 CE pin
+constexpr int NRF24L01_CSN_PIN  = 17;       /// < nRF24L01 CSN pin
+constexpr int NRF24L01_MOSI_PIN = 19;       /// < nRF24L01 MOSI pin
+constexpr int NRF24L01_MISO_PIN = 16;       /// < nRF24L01 MISO pin
+constexpr int NRF24L01_SCK_PIN  = 18;       /// < nRF24L01 SCK pin
+
+constexpr int VOLTAGE_MONITOR_PIN = A2;     /// < Voltage monitor pin (GP28)
+constexpr int LOW_VOLTAGE_LED_PIN = 21;     /// < Low voltage indicator LED pin
+constexpr int SWITCH_TRANSMISSION_MODE_PIN = 22; /// < Switch transmission mode pin
+
+constexpr int IMU_SDA_PIN = 4;              /// < IMU I2C data pin
+constexpr int IMU_SCL_PIN = 5;              /// < IMU I2C clock pin
+
+#else
+// Arduino Uno / Nano, also used by host builds
 // Serial is using pins 0 (RX) and 1 (TX), so avoid using them for other purposes
 
 // Joystick pin definitions
@@ -26,6 +58,28 @@ constexpr int NRF24L01_SCK_PIN  = 13;       /// < nRF24L01 SCK pin
 
 constexpr int VOLTAGE_MONITOR_PIN = A2;     /// < Voltage monitor pin
 constexpr int LOW_VOLTAGE_LED_PIN = A3;     /// < Low voltage indicator LED pin
-constexpr int SWITCH_TRANSMISSION_MODE_PIN = A4; /// < Switch transmission mode pin
+constexpr int SWITCH_TRANSMISSION_MODE_PIN = A4; /// < Switch transmission mode pin, unused with ENABLE_IMU
+
+// MPU-6050 uses hardware I2C on A4 (SDA) and A5 (SCL), so transmission mode switch is not available with IMU
+constexpr int IMU_SDA_PIN = A4;             /// < IMU I2C data pin
+constexpr int IMU_SCL_PIN = A5;             /// < IMU I2C clock pin
+#endif
+
+// Pin types for Hal, input and radio code is written against these only
+namespace Board
+{
+using JoystickX = Hal::Pin<JOYSTICK_X_PIN>;
+using JoystickY = Hal::Pin<JOYSTICK_Y_PIN>;
+using JoystickButton = Hal::Pin<JOYSTICK_BUTTON_PIN>;
+using ButtonA = Hal::Pin<A_PIN>;
+using ButtonB = Hal::Pin<B_PIN>;
+using ButtonC = Hal::Pin<C_PIN>;
+using ButtonD = Hal::Pin<D_PIN>;
+using ButtonE = Hal::Pin<E_PIN>;
+using ButtonF = Hal::Pin<F_PIN>;
+using LowVoltageLed = Hal::Pin<LOW_VOLTAGE_LED_PIN>;
+using TransmissionModeSwitch = Hal::Pin<SWITCH_TRANSMISSION_MODE_PIN>;
+using Radio = Hal::RadioPins<Hal::Pin<NRF24L01_CE_PIN>, Hal::Pin<NRF24L01_CSN_PIN>>;
+}   // namespace Board
 
 #endif
@@ -0,0 +1,48 @@
+#ifndef POWER_MANAGER_H_
+#define POWER_MANAGER_H_
+
+#include <Arduino.h>
+
+// Keeps the main loop on a fixed tick and sleeps the MCU between ticks.
+// A change on any button pin wakes the loop before the tick is due.
+class PowerManager
+{
+public:
+    // @param tick_period_us: time between scheduled loop ticks (in microseconds)
+    explicit PowerManager(uint32_t tick_period_us);
+
+    // Destructor
+    ~PowerManager() = default;
+
+    // Configure sleep mode and enable pin-change wake-up on button pins
+    void Initialize();
+
+    // Sleep until the next scheduled tick or until a button changes state
+    // @return true when woken early by a button
+    bool SleepUntilNextTick();
+
+    // Change the tick period, takes effect from the next tick
+    void SetTickPeriod(uint32_t tick_period_us);
+
+    // Move the next tick to tick_us, keeps the loop in phase with an external time base.
+    // Ignored if tick_us is in the past or more than two periods ahead.
+    void AlignNextTick(uint32_t tick_us);
+
+    // Get current tick period (in microseconds)
+    uint32_t GetTickPeriod() const { return tick_period_us_; }
+
+    // Get total time spent waiting for ticks since boot (in microseconds, wraps)
+    uint32_t GetIdleTimeUs() const { return idle_time_us_; }
+
+private:
+    // Put the MCU in idle sleep until the next interrupt
+    void EnterIdleSleep();
+
+    // Member variables
+    uint32_t tick_period_us_;
+    uint32_t next_tick_us_;
+    uint32_t idle_time_us_;
+    bool is_initialized_;
+};
+
+#endif // POWER_MANAGER_H_
@@ -0,0 +1,74 @@
+#ifndef SETTINGS_STORE_H_
+#define SETTINGS_STORE_H_
+
+#include <Arduino.h>
+#include "joystick_shield_struct.h"
+#include "config.h"
+
+// Settings persisted between power cycles
+struct Settings {
+    CalibrationData calibration;    // joystick calibration, calibrated == false forces boot calibration
+    uint8_t radio_address[5];       // nRF24 writing pipe address
+    uint8_t radio_channel;          // nRF24 channel (0 - 125)
+    uint8_t pa_level;               // nRF24 power amplifier level
+    uint8_t log_level;              // ArduinoLog level
+    uint16_t loop_rate_hz;          // main loop rate
+    int16_t pid_gains_q8[kPidGainCount];    // robot PID settings 1 - 4, signed Q8 (256 = 1.0)
+    uint8_t pid_gain_mask;          // bit per gain sent to robot when BLE link comes up, 0 sends nothing
+    uint8_t controller_id;          // controller number within team (0 - kMaxControllerId), selects TDMA slot
+};
+
+// Versioned, CRC protected settings store in EEPROM.
+// Every save goes to the next slot of a ring, the newest valid slot is loaded on boot,
+// so each EEPROM cell is written only once per kSlotCount saves.
+class SettingsStore
+{
+public:
+    SettingsStore();
+
+    // Destructor
+    ~SettingsStore() = default;
+
+    // Load newest valid settings from EEPROM
+    // @return false if no valid record was found, settings are left unchanged
+    bool Load(Settings* settings);
+
+    // Save settings to next slot in EEPROM
+    bool Save(const Settings& settings);
+
+    // Fill settings with compile time defaults
+    static void LoadDefaults(Settings* settings);
+
+private:
+    // Bump when Settings layout changes, old records are then ignored
+    static constexpr uint8_t kVersion = 4;
+    static constexpr uint8_t kMagic = 0xA5;
+    static constexpr uint16_t kEepromStart = 0;
+    static constexpr uint16_t kEepromSize = 512;
+
+    struct Record {
+        uint8_t magic;
+        uint8_t version;
+        uint16_t sequence;      // incremented on every save, newest record wins
+        Settings settings;
+        uint16_t crc;           // CRC-16/CCITT of all preceding bytes
+    };
+
+    static constexpr uint8_t kSlotCount = kEepromSize / sizeof(Record);
+    static_assert(kSlotCount >= 2, "Settings record too big for wear leveling");
+
+    // Read record from slot and validate it
+    static bool ReadSlot(uint8_t slot, Record* record);
+
+    // Calculate CRC of record without CRC field
+    static uint16_t CalculateCrc(const Record& record);
+
+    // Get EEPROM address of slot
+    static uint16_t SlotAddress(uint8_t slot);
+
+    // Member variables
+    uint8_t next_slot_;
+    uint16_t next_sequence_;
+};
+
+#endif // SETTINGS_STORE_H_
@@ -0,0 +1,148 @@
+/*
+    Single-producer / single-consumer ring buffer for passing data between
+    interrupt and loop context without disabling interrupts.
+    Head is written only by producer, tail only by consumer. Both are free running
+    8-bit counters, a byte load / store is a single instruction on AVR, so neither
+    side can observe a torn index. Element is copied before index is published.
+
+    Ring is used either as queue (push / pop) or as mailbox of latest value
+    (publish / peekLatest), the two modes must not be mixed on one instance.
+*/
+#pragma once
+
+#include <stdint.h>
+
+namespace SpscDetail
+{
+#if defined(__AVR__)
+// Single core: volatile access plus compiler barrier keeps copy and index update in order
+inline uint8_t loadAcquire(const uint8_t &index) {
+    const uint8_t value = *static_cast<const volatile uint8_t*>(&index);
+    __asm__ __volatile__("" ::: "memory");
+    return value;
+}
+inline void storeRelease(uint8_t &index, uint8_t value) {
+    __asm__ __volatile__("" ::: "memory");
+    *static_cast<volatile uint8_t*>(&index) = value;
+}
+inline void fenceAcquire() {
+    __asm__ __volatile__("" ::: "memory");
+}
+#else
+inline uint8_t loadAcquire(const uint8_t &index) {
+    return __atomic_load_n(&index, __ATOMIC_ACQUIRE);
+}
+inline void storeRelease(uint8_t &index, uint8_t value) {
+    __atomic_store_n(&index, value, __ATOMIC_RELEASE);
+}
+// Keeps loads before the fence from moving below a later load, acquire load alone allows it
+inline void fenceAcquire() {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+#endif
+}   // namespace SpscDetail
+
+template <typename T, uint8_t Size>
+class SpscRing
+{
+    // 8-bit counters distinguish full from empty up to 128 elements
+    static_assert(Size >= 2 && Size <= 128, "Ring size must be 2..128");
+    static_assert((Size & (Size - 1)) == 0, "Ring size must be power of two");
+
+public:
+    SpscRing(): items_{}, head_(0), tail_(0) {}
+
+    static constexpr uint8_t capacity() { return Size; }
+
+    // Producer: add item
+    // @return false if ring is full, item is dropped
+    bool push(const T &item) {
+        const uint8_t head = head_;
+        if (static_cast<uint8_t>(head - SpscDetail::loadAcquire(tail_)) >= Size) {
+            return false;
+        }
+        items_[head & kMask] = item;
+        SpscDetail::storeRelease(head_, head + 1);
+        return true;
+    }
+
+    // Producer: add up to count items with single index update
+    // @return number of items added
+    uint8_t push(const T *items, uint8_t count) {
+        const uint8_t head = head_;
+        const uint8_t space = Size - static_cast<uint8_t>(head - SpscDetail::loadAcquire(tail_));
+        if (count > space) {
+            count = space;
+        }
+        for (uint8_t i = 0; i < count; ++i) {
+            items_[static_cast<uint8_t>(head + i) & kMask] = items[i];
+        }
+        SpscDetail::storeRelease(head_, head + count);
+        return count;
+    }
+
+    // Consumer: take oldest item
+    // @return false if ring is empty
+    bool pop(T &item) {
+        const uint8_t tail = tail_;
+        if (SpscDetail::loadAcquire(head_) == tail) {
+            return false;
+        }
+        item = items_[tail & kMask];
+        SpscDetail::storeRelease(tail_, tail + 1);
+        return true;
+    }
+
+    // Consumer: take up to max_count oldest items with single index update
+    // @return number of items taken
+    uint8_t pop(T *items, uint8_t max_count) {
+        const uint8_t tail = tail_;
+        uint8_t count = SpscDetail::loadAcquire(head_) - tail;
+        if (count > max_count) {
+            count = max_count;
+        }
+        for (uint8_t i = 0; i < count; ++i) {
+            items[i] = items_[static_cast<uint8_t>(tail + i) & kMask];
+        }
+        SpscDetail::storeRelease(tail_, tail + count);
+        return count;
+    }
+
+    // Producer: store newest value, never blocks, older values are overwritten
+    void publish(const T &item) {
+        const uint8_t head = head_;
+        items_[head & kMask] = item;
+        // Head 0 means nothing published, wrap continues at Size which maps to the same slot
+        const uint8_t next = head + 1;
+        SpscDetail::storeRelease(head_, next != 0 ? next : Size);
+    }
+
+    // Consumer: copy newest published value without removing it
+    // @return false if nothing was published yet, or producer lapped the ring during copy
+    bool peekLatest(T &item) const {
+        const uint8_t head = SpscDetail::loadAcquire(head_);
+        if (head == 0) {
+            return false;
+        }
+        item = items_[static_cast<uint8_t>(head - 1) & kMask];
+        // Copy must complete before head is checked again, on multi-core targets too
+        SpscDetail::fenceAcquire();
+        // Copied slot is rewritten only after Size - 1 further publishes,
+        // skipped counter values at wrap make this check conservative
+        return static_cast<uint8_t>(SpscDetail::loadAcquire(head_) - head) < Size - 1;
+    }
+
+    // Number of queued items, consumer may see too few and producer too many while the other side runs
+    uint8_t size() const {
+        return SpscDetail::loadAcquire(head_) - SpscDetail::loadAcquire(tail_);
+    }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() >= Size; }
+
+private:
+    static constexpr uint8_t kMask = Size - 1;
+
+    T items_[Size];
+    uint8_t head_;
+    uint8_t tail_;
+};
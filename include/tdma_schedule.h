@@ -0,0 +1,71 @@
+/*
+    Time division of one radio channel between controllers sharing a receiver.
+    Receiver sends a beacon in slot 0 of every superframe, controllers lock their
+    micros() clock to the beacon time base and transmit only in their own slot.
+    Code has no hardware dependencies, so clock drift can be simulated on host.
+*/
+#pragma once
+
+#include <stdint.h>
+
+namespace Tdma
+{
+constexpr uint8_t kBeaconType = 0xB5;
+constexpr uint8_t kBeaconSlot = 0;          // slot 0 of every superframe belongs to receiver
+constexpr uint8_t kNoSlot = 0xFF;           // pairing ID or controller id outside of slot layout
+constexpr uint8_t kMinSlotCount = 2;
+constexpr uint32_t kLockTimeoutUs = 500000; // clock is unlocked after this time without beacon
+constexpr uint32_t kBeaconLatencyUs = 350;  // write call to RX_DR on controller, 32 bytes at 1 Mbps
+
+// Sent by receiver at start of every superframe, fits into single payload
+struct Beacon {
+    uint8_t type;           // kBeaconType, identifies beacon payload
+    uint8_t slot_count;     // slots per superframe including beacon slot
+    uint16_t slot_us;       // slot length
+    uint32_t time_us;       // receiver time base when beacon was written
+    uint8_t base_pairing_id;    // pairing ID of receiver pipe 1, pipe N is served with base + N - 1
+    uint8_t ids_per_pipe;       // controller ids 0 .. ids_per_pipe - 1 get a slot on every pipe
+    uint8_t reserved[2];        // same size with and without 4 byte alignment
+};
+static_assert(sizeof(Beacon) == 12, "Beacon layout has to match on AVR and 32-bit receivers");
+
+// Slot of controller in layout of beacon: pipe index (pairing ID, radio address LSB, relative to
+// base pairing ID) times ids per pipe plus controller id, so every pair gets its own slot
+// @return kNoSlot if pipe index or controller id does not fit into the data slots
+uint8_t assignSlot(uint8_t pairing_id, int8_t controller_id, const Beacon &beacon);
+
+// Local view of receiver time base, offset is reset by every beacon and drift between beacons is compensated
+class Clock
+{
+public:
+    Clock();
+
+    // Feed beacon received at local time local_us
+    // @return false if beacon is invalid
+    bool onBeacon(const Beacon &beacon, uint32_t local_us);
+    // Check if beacon was received within kLockTimeoutUs
+    bool isLocked(uint32_t local_us) const;
+    // Convert local micros() to receiver time base
+    uint32_t toNetworkUs(uint32_t local_us) const;
+    // Local time of next start of slot, not earlier than local_us
+    uint32_t nextSlotStartUs(uint8_t slot, uint32_t local_us) const;
+    // Superframe length of last beacon
+    uint32_t superframeUs() const { return static_cast<uint32_t>(slot_count_) * slot_us_; }
+    uint8_t slotCount() const { return slot_count_; }
+    uint16_t slotUs() const { return slot_us_; }
+    // Estimated drift of local clock against receiver, positive if local clock is slow
+    int32_t driftPpm() const { return drift_ppm_; }
+
+private:
+    // Drift correction of local interval, fits int32 for intervals up to kLockTimeoutUs
+    int32_t correctionUs(uint32_t local_interval_us) const;
+
+    uint32_t beacon_network_us_;
+    uint32_t beacon_local_us_;
+    int32_t drift_ppm_;
+    uint16_t slot_us_;
+    uint8_t slot_count_;
+    bool has_beacon_;
+};
+
+}   // namespace Tdma
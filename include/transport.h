@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Bluepad32_data_struct.h"
+
+// Common interface of links which deliver controller frames to the robot
+class Transport
+{
+public:
+    virtual ~Transport() = default;
+    // send single controller frame, must not block longer than the frame air/serial time
+    virtual bool sendFrame(const BP32Data::PackedControllerData &data) = 0;
+    // check if transport can accept frames
+    virtual bool isReady() const = 0;
+    // transport name for logging
+    virtual const char* name() const = 0;
+};
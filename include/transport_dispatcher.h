@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Arduino.h>
+#include "transport.h"
+
+// Sends each frame to active transports, every transport has its own rate limit,
+// so a slow transport only skips its own frames and never delays the others
+class TransportDispatcher
+{
+public:
+    static constexpr uint8_t kMaxTransports = 2;
+
+    TransportDispatcher();
+    ~TransportDispatcher() = default;
+
+    // register transport with minimal interval between frames (0 = every dispatch)
+    // @return transport bit used in active masks, 0 if there is no free slot
+    uint8_t addTransport(Transport* transport, uint32_t min_interval_us);
+    // select transports used by dispatch
+    void setActiveMask(uint8_t mask);
+    // get selected transports
+    uint8_t getActiveMask() const { return active_mask_; }
+    // send frame to active transports which are ready and not rate limited
+    // @return mask of transports which sent frame successfully
+    uint8_t dispatch(const BP32Data::PackedControllerData &data, uint32_t now_us);
+
+private:
+    struct Entry {
+        Transport* transport;
+        uint32_t min_interval_us;
+        uint32_t last_send_us;
+        bool has_sent;
+    };
+
+    Entry entries_[kMaxTransports];
+    uint8_t count_;
+    uint8_t active_mask_;
+};
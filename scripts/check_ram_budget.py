@@ -0,0 +1,27 @@
+# PlatformIO post-build step: fail the build when static RAM (.data + .bss) exceeds budget.
+# Budget is set with custom_ram_budget in platformio.ini, the rest of SRAM is left for stack and heap.
+Import("env")
+
+import re
+import subprocess
+
+
+def check_ram_budget(source, target, env):
+    budget = int(env.GetProjectOption("custom_ram_budget", "0"))
+    if budget <= 0:
+        return
+    elf = str(target[0])
+    output = subprocess.check_output([env.subst("$SIZETOOL"), "-A", elf], universal_newlines=True)
+    sections = {}
+    for line in output.splitlines():
+        match = re.match(r"^(\.\w+)\s+(\d+)", line)
+        if match:
+            sections[match.group(1)] = int(match.group(2))
+    static_ram = sections.get(".data", 0) + sections.get(".bss", 0) + sections.get(".noinit", 0)
+    print("Static RAM: %d of %d bytes budget" % (static_ram, budget))
+    if static_ram > budget:
+        print("Error: static RAM exceeds budget by %d bytes" % (static_ram - budget))
+        env.Exit(1)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_ram_budget)
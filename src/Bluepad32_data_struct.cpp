@@ -1,12 +1,17 @@
+#include <string.h>
 #include "Bluepad32_data_struct.h"
 
 BP32Data::ControllerDataManager::ControllerDataManager():
-    _controller_data({}) {  // set all values to zero
+    _controller_data({}),   // set all values to zero
+    _changed_fields(0),
+    _subscriptions{} {
 
 }
 
 BP32Data::ControllerDataManager::ControllerDataManager(const PackedControllerData & data):
-    _controller_data(data) {
+    _controller_data(data),
+    _changed_fields(ControllerFieldConst::kFieldAll),
+    _subscriptions{} {
 }
 
 BP32Data::ControllerDataManager & BP32Data::ControllerDataManager::operator=(const PackedControllerData & data) {
@@ -14,11 +19,60 @@ BP32Data::ControllerDataManager & BP32Data::ControllerDataManager::operator=(con
     return *this;
 }
 
-void BP32Data::ControllerDataManager::setControllerData(const PackedControllerData & data) {
+uint16_t BP32Data::ControllerDataManager::setControllerData(const PackedControllerData & data) {
+    _changed_fields = compareFields(_controller_data, data);
+    if (_changed_fields == 0) {
+        return 0;
+    }
     _controller_data = data;
+    for (const auto &subscription : _subscriptions) {
+        if (subscription.callback != nullptr && (subscription.fields & _changed_fields)) {
+            subscription.callback(subscription.context, *this, _changed_fields);
+        }
+    }
+    return _changed_fields;
 }
 
 BP32Data::PackedControllerData BP32Data::ControllerDataManager::getControllerData() const {
     return _controller_data;
 }
 
+bool BP32Data::ControllerDataManager::subscribe(uint16_t fields, ControllerChangeCallback callback, void *context) {
+    if (callback == nullptr) {
+        return false;
+    }
+    for (auto &subscription : _subscriptions) {
+        if (subscription.callback == nullptr) {
+            subscription = Subscription{callback, context, fields};
+            return true;
+        }
+    }
+    return false;
+}
+
+void BP32Data::ControllerDataManager::unsubscribe(ControllerChangeCallback callback, void *context) {
+    for (auto &subscription : _subscriptions) {
+        if (subscription.callback == callback && subscription.context == context) {
+            subscription = Subscription{};
+        }
+    }
+}
+
+uint16_t BP32Data::ControllerDataManager::compareFields(const PackedControllerData &previous,
+                                                        const PackedControllerData &data) {
+    using namespace ControllerFieldConst;
+    uint16_t changed = 0;
+    if (previous.id != data.id) changed |= kFieldId;
+    if (previous.dpad != data.dpad) changed |= kFieldDpad;
+    if (previous.axis_x != data.axis_x) changed |= kFieldAxisX;
+    if (previous.axis_y != data.axis_y) changed |= kFieldAxisY;
+    if (previous.axis_rx != data.axis_rx) changed |= kFieldAxisRX;
+    if (previous.axis_ry != data.axis_ry) changed |= kFieldAxisRY;
+    if (previous.brake != data.brake) changed |= kFieldBrake;
+    if (previous.throttle != data.throttle) changed |= kFieldThrottle;
+    if (previous.buttons != data.buttons) changed |= kFieldButtons;
+    if (previous.misc_buttons != data.misc_buttons) changed |= kFieldMiscButtons;
+    if (memcmp(previous.gyro, data.gyro, sizeof(data.gyro)) != 0) changed |= kFieldGyro;
+    if (memcmp(previous.accel, data.accel, sizeof(data.accel)) != 0) changed |= kFieldAccel;
+    return changed;
+}
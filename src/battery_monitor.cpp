@@ -0,0 +1,155 @@
+#include "battery_monitor.h"
+#include "config.h"
+#include "log.h"
+
+namespace
+{
+// Voltage at which each degraded state is entered, indexed by state - 1
+constexpr uint16_t kEnterStateMv[] = {
+    kBatteryLowMv, kBatteryCriticalMv, kBatteryDyingMv
+};
+constexpr uint8_t kWorstState = static_cast<uint8_t>(BatteryState::kDying);
+constexpr uint32_t kMsPerHour = 3600000UL;
+}
+
+BatteryMonitor::BatteryMonitor(int voltage_pin)
+    : voltage_pin_(voltage_pin),
+      filtered_mv_q_(0),
+      last_sample_ms_(0),
+      rate_window_start_ms_(0),
+      rate_window_start_mv_(0),
+      discharge_mv_per_hour_(0),
+      state_(BatteryState::kNormal),
+      is_initialized_(false)
+{
+}
+
+void BatteryMonitor::Initialize()
+{
+    const uint16_t voltage_mv = ReadVoltageMv();
+    filtered_mv_q_ = static_cast<uint32_t>(voltage_mv) << kFilterShift;
+    last_sample_ms_ = millis();
+    rate_window_start_ms_ = last_sample_ms_;
+    rate_window_start_mv_ = voltage_mv;
+    is_initialized_ = true;
+    LOG_INFO("Battery monitor initialized: %d mV", voltage_mv);
+}
+
+bool BatteryMonitor::Update()
+{
+#ifdef ENABLE_LOW_VOLTAGE_PROTECTION
+    if (!is_initialized_)
+    {
+        Initialize();
+    }
+
+    const uint32_t now_ms = millis();
+    if (now_ms - last_sample_ms_ < kBatterySamplePeriodMs)
+    {
+        return false;
+    }
+    last_sample_ms_ = now_ms;
+
+    // Exponential moving average: q = q - q / 2^k + sample
+    filtered_mv_q_ = filtered_mv_q_ - (filtered_mv_q_ >> kFilterShift) + ReadVoltageMv();
+    const uint16_t voltage_mv = GetVoltageMv();
+    LOG_DEBUG("Battery voltage: %d mV", voltage_mv);
+
+    if (!IsBatteryConnected())
+    {
+        // Powered from USB, nothing to protect
+        return false;
+    }
+
+    UpdateDischargeRate(now_ms);
+
+    const BatteryState new_state = EvaluateState(voltage_mv);
+    if (new_state == state_)
+    {
+        return false;
+    }
+    LOG_WARNING("Battery state %s -> %s at %d mV",
+                StateToString(state_), StateToString(new_state), voltage_mv);
+    state_ = new_state;
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint16_t BatteryMonitor::GetRemainingRuntimeMin() const
+{
+    const uint16_t voltage_mv = GetVoltageMv();
+    if (discharge_mv_per_hour_ == 0 || !IsBatteryConnected())
+    {
+        return kUnknownRuntime;
+    }
+    if (voltage_mv <= kBatteryDyingMv)
+    {
+        return 0;
+    }
+    const uint32_t runtime_min = static_cast<uint32_t>(voltage_mv - kBatteryDyingMv) * 60U / discharge_mv_per_hour_;
+    return runtime_min < kUnknownRuntime ? static_cast<uint16_t>(runtime_min) : kUnknownRuntime - 1;
+}
+
+bool BatteryMonitor::IsBatteryConnected() const
+{
+    return GetVoltageMv() > kBatteryDisconnectedMv;
+}
+
+const char* BatteryMonitor::StateToString(BatteryState state)
+{
+    switch (state)
+    {
+        case BatteryState::kNormal:   return "NORMAL";
+        case BatteryState::kLow:      return "LOW";
+        case BatteryState::kCritical: return "CRITICAL";
+        case BatteryState::kDying:    return "DYING";
+        default:                      return "UNKNOWN";
+    }
+}
+
+uint16_t BatteryMonitor::ReadVoltageMv() const
+{
+    const uint32_t adc_value = analogRead(voltage_pin_);
+    return static_cast<uint16_t>(adc_value * kBatteryAdcReferenceMv * kBatteryDividerRatio / 1023UL);
+}
+
+BatteryState BatteryMonitor::EvaluateState(uint16_t voltage_mv) const
+{
+    auto state = static_cast<uint8_t>(state_);
+    if (state == kWorstState)
+    {
+        // Final frame is sent only once, controller does not recover from dying state
+        return state_;
+    }
+    // Degrade immediately, possibly across several states at once
+    while (state < kWorstState && voltage_mv < kEnterStateMv[state])
+    {
+        ++state;
+    }
+    // Recover only when voltage rises above threshold with hysteresis
+    while (state > 0 && voltage_mv >= kEnterStateMv[state - 1] + kBatteryHysteresisMv)
+    {
+        --state;
+    }
+    return static_cast<BatteryState>(state);
+}
+
+void BatteryMonitor::UpdateDischargeRate(uint32_t now_ms)
+{
+    const uint32_t elapsed_ms = now_ms - rate_window_start_ms_;
+    if (elapsed_ms < kBatteryRateWindowMs)
+    {
+        return;
+    }
+    const uint16_t voltage_mv = GetVoltageMv();
+    if (rate_window_start_mv_ > voltage_mv)
+    {
+        const uint32_t drop_mv = rate_window_start_mv_ - voltage_mv;
+        const uint32_t rate = drop_mv * (kMsPerHour / 1000UL) / (elapsed_ms / 1000UL);
+        discharge_mv_per_hour_ = rate < 0xFFFF ? static_cast<uint16_t>(rate) : 0xFFFF;
+    }
+    rate_window_start_ms_ = now_ms;
+    rate_window_start_mv_ = voltage_mv;
+}
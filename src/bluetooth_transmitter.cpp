@@ -8,8 +8,24 @@ BluetoothTransmitter::BluetoothTransmitter()
 
 BluetoothTransmitter::BluetoothTransmitter(HardwareSerial *serial_ble)
     : serial_ble_(serial_ble),
-      last_command_(""),
+      stick_source_(nullptr),
+      last_command_{},
       last_command_time_(0),
+      has_sent_command_(false),
+      state_time_ms_(0),
+      last_rx_ms_(0),
+      rx_buffer_{},
+      rx_length_(0),
+      last_ack_(0),
+      pid_batch_frame_{},
+      pid_batch_length_(0),
+      pid_batch_retries_(0),
+      pid_batch_sequence_(0),
+      pid_batch_time_ms_(0),
+      pid_batch_state_(PidBatchState::kIdle),
+      link_state_(BleLinkState::kOff),
+      is_baud_confirmed_(false),
+      baud_attempts_(0),
       is_initialized_(false)
 {
     LOG_INFO("BluetoothTransmitter initialized with custom HardwareSerial");
@@ -17,17 +33,83 @@ BluetoothTransmitter::BluetoothTransmitter(HardwareSerial *serial_ble)
 
 bool BluetoothTransmitter::Initialize()
 {
-    serial_ble_->end(); // Ensure any previous connection is closed
-    serial_ble_->begin(kBaudRate);
-    // TODO: Toggle EN pin when AT commands are send
-    serial_ble_->print("AT+BAUD3");
-    serial_ble_->end(); // Ensure any previous connection is closed
-    serial_ble_->begin(38400);
+    is_baud_confirmed_ = false;
+    baud_attempts_ = 0;
+    StartBaudSetup();
 
     is_initialized_ = true;
     return is_initialized_;
 }
 
+void BluetoothTransmitter::Update()
+{
+    if (!is_initialized_)
+    {
+        return;
+    }
+    ReadResponses();
+
+    const uint32_t now = millis();
+    switch (link_state_)
+    {
+        case BleLinkState::kSettingBaud:
+            if (now - state_time_ms_ >= kAtResponseTimeoutMs)
+            {
+                // Module may already run at target baud rate, verify it anyway
+                HandleAtResponse();
+            }
+            break;
+        case BleLinkState::kVerifyingBaud:
+            if (now - state_time_ms_ < kAtResponseTimeoutMs)
+            {
+                break;
+            }
+            if (baud_attempts_ < kBaudMaxAttempts)
+            {
+                // Module may still run at default baud rate
+                LOG_WARNING("BLE module did not confirm baud rate, retrying");
+                StartBaudSetup();
+            }
+            else
+            {
+                // Module ignores AT commands while paired, robot message at target baud rate confirms it
+                LOG_WARNING("BLE module did not confirm baud rate");
+                SetLinkState(BleLinkState::kDisconnected);
+            }
+            break;
+        case BleLinkState::kDisconnected:
+            if (!is_baud_confirmed_ && now - state_time_ms_ >= kUnconfirmedBaudTimeoutMs)
+            {
+                // Nothing parsed at target baud rate, start over instead of staying deaf
+                baud_attempts_ = 0;
+                StartBaudSetup();
+            }
+            break;
+        case BleLinkState::kConnected:
+            if (now - last_rx_ms_ >= kHeartbeatTimeoutMs)
+            {
+                LOG_WARNING("BLE heartbeat lost");
+                SetLinkState(BleLinkState::kDisconnected);
+            }
+            break;
+        default:
+            break;
+    }
+    UpdatePidBatch();
+}
+
+void BluetoothTransmitter::Shutdown()
+{
+    if (!is_initialized_)
+    {
+        return;
+    }
+    serial_ble_->flush();
+    serial_ble_->end();
+    is_initialized_ = false;
+    SetLinkState(BleLinkState::kOff);
+}
+
 bool BluetoothTransmitter::SendSpeedCommand(int16_t x_value, int16_t y_value)
 {
     if (!ValidatePadValues(x_value, y_value))
@@ -35,8 +117,9 @@ bool BluetoothTransmitter::SendSpeedCommand(int16_t x_value, int16_t y_value)
         return false;
     }
 
-    String command = BuildPadCommand(CommandType::kSpeed, x_value, y_value);
-    return SendCommand(command);
+    char command[kMaxCommandLength + 1];
+    const size_t length = BuildPadCommand(CommandType::kSpeed, x_value, y_value, command);
+    return SendCommand(command, length);
 }
 
 bool BluetoothTransmitter::SendRotationCommand(int16_t x_value, int16_t y_value)
@@ -46,22 +129,21 @@ bool BluetoothTransmitter::SendRotationCommand(int16_t x_value, int16_t y_value)
         return false;
     }
 
-    String command = BuildPadCommand(CommandType::kRotate, x_value, y_value);
-    return SendCommand(command);
+    char command[kMaxCommandLength + 1];
+    const size_t length = BuildPadCommand(CommandType::kRotate, x_value, y_value, command);
+    return SendCommand(command, length);
 }
 
 bool BluetoothTransmitter::SendAngleOffsetIncrease()
 {
-    String command = String(static_cast<char>(CommandType::kAngleOffsetIncrease));
-    command += kMessageDelimiter;
-    return SendCommand(command);
+    const char command[] = {static_cast<char>(CommandType::kAngleOffsetIncrease), kMessageDelimiter};
+    return SendCommand(command, sizeof(command));
 }
 
 bool BluetoothTransmitter::SendAngleOffsetDecrease()
 {
-    String command = String(static_cast<char>(CommandType::kAngleOffsetDecrease));
-    command += kMessageDelimiter;
-    return SendCommand(command);
+    const char command[] = {static_cast<char>(CommandType::kAngleOffsetDecrease), kMessageDelimiter};
+    return SendCommand(command, sizeof(command));
 }
 
 bool BluetoothTransmitter::SendPidSetting1(const String &data)
@@ -69,7 +151,7 @@ bool BluetoothTransmitter::SendPidSetting1(const String &data)
     String command = String(static_cast<char>(CommandType::kPidSetting1));
     command += data;
     command += kMessageDelimiter;
-    return SendCommand(command);
+    return SendCommand(command.c_str(), command.length());
 }
 
 bool BluetoothTransmitter::SendPidSetting2(const String &data)
@@ -77,7 +159,7 @@ bool BluetoothTransmitter::SendPidSetting2(const String &data)
     String command = String(static_cast<char>(CommandType::kPidSetting2));
     command += data;
     command += kMessageDelimiter;
-    return SendCommand(command);
+    return SendCommand(command.c_str(), command.length());
 }
 
 bool BluetoothTransmitter::SendPidSetting3(const String &data)
@@ -85,7 +167,7 @@ bool BluetoothTransmitter::SendPidSetting3(const String &data)
     String command = String(static_cast<char>(CommandType::kPidSetting3));
     command += data;
     command += kMessageDelimiter;
-    return SendCommand(command);
+    return SendCommand(command.c_str(), command.length());
 }
 
 bool BluetoothTransmitter::SendPidSetting4(const String &data)
@@ -93,7 +175,59 @@ bool BluetoothTransmitter::SendPidSetting4(const String &data)
     String command = String(static_cast<char>(CommandType::kPidSetting4));
     command += data;
     command += kMessageDelimiter;
-    return SendCommand(command);
+    return SendCommand(command.c_str(), command.length());
+}
+
+bool BluetoothTransmitter::SendPidBatch(const PidParameter* params, uint8_t count)
+{
+    if (params == nullptr || count == 0 || count > kMaxBatchParams)
+    {
+        LOG_WARNING("Invalid PID batch size: %d", count);
+        return false;
+    }
+    if (pid_batch_state_ == PidBatchState::kPending)
+    {
+        LOG_WARNING("PID batch still pending");
+        return false;
+    }
+    if (!IsConnected())
+    {
+        return false;
+    }
+
+    static constexpr char kHexDigits[] = "0123456789ABCDEF";
+    ++pid_batch_sequence_;
+    uint8_t length = 0;
+    pid_batch_frame_[length++] = static_cast<char>(CommandType::kPidBatch);
+    pid_batch_frame_[length++] = kHexDigits[pid_batch_sequence_ >> 4];
+    pid_batch_frame_[length++] = kHexDigits[pid_batch_sequence_ & 0x0F];
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        const auto value = static_cast<uint16_t>(params[i].value_q8);
+        pid_batch_frame_[length++] = static_cast<char>(params[i].type);
+        pid_batch_frame_[length++] = kHexDigits[(value >> 12) & 0x0F];
+        pid_batch_frame_[length++] = kHexDigits[(value >> 8) & 0x0F];
+        pid_batch_frame_[length++] = kHexDigits[(value >> 4) & 0x0F];
+        pid_batch_frame_[length++] = kHexDigits[value & 0x0F];
+    }
+    uint8_t checksum = 0;
+    for (uint8_t i = 0; i < length; ++i)
+    {
+        checksum ^= static_cast<uint8_t>(pid_batch_frame_[i]);
+    }
+    pid_batch_frame_[length++] = kHexDigits[checksum >> 4];
+    pid_batch_frame_[length++] = kHexDigits[checksum & 0x0F];
+    pid_batch_frame_[length++] = kMessageDelimiter;
+    pid_batch_frame_[length] = '\0';
+    pid_batch_length_ = length;
+
+    last_ack_ = 0;
+    pid_batch_retries_ = 0;
+    pid_batch_time_ms_ = millis();
+    pid_batch_state_ = PidBatchState::kPending;
+    // First attempt may be dropped when serial is busy, Update retries it
+    WriteCommand(pid_batch_frame_, pid_batch_length_);
+    return true;
 }
 
 bool BluetoothTransmitter::SendRawCommand(const String &command)
@@ -110,40 +244,74 @@ bool BluetoothTransmitter::SendRawCommand(const String &command)
         formatted_command += kMessageDelimiter;
     }
 
-    return SendCommand(formatted_command);
+    return SendCommand(formatted_command.c_str(), formatted_command.length());
 }
 
 bool BluetoothTransmitter::IsConnected() const
 {
-    return is_initialized_;
-    // Note: For more robust connection checking, you might want to
-    // implement a heartbeat mechanism or check for responses
+    return link_state_ == BleLinkState::kConnected;
+}
+
+bool BluetoothTransmitter::sendFrame(const BP32Data::PackedControllerData &data)
+{
+    const int32_t x_axis = stick_source_ != nullptr ? stick_source_->x_calibrated : data.axis_x;
+    const int32_t y_axis = stick_source_ != nullptr ? stick_source_->y_calibrated : data.axis_y;
+    const auto x_value = static_cast<int16_t>(constrain(x_axis >> kFrameAxisShift, kMinPadValue, kMaxPadValue));
+    const auto y_value = static_cast<int16_t>(constrain(y_axis >> kFrameAxisShift, kMinPadValue, kMaxPadValue));
+    return SendSpeedCommand(x_value, y_value);
 }
 
-unsigned long BluetoothTransmitter::GetTimeSinceLastCommand() const
+uint32_t BluetoothTransmitter::GetTimeSinceLastCommand() const
 {
-    if (last_command_time_ == 0)
+    if (!has_sent_command_)
     {
         return 0;
     }
     return millis() - last_command_time_;
 }
 
-String BluetoothTransmitter::BuildPadCommand(CommandType type,
+size_t BluetoothTransmitter::BuildPadCommand(CommandType type,
                                              int16_t x_value,
-                                             int16_t y_value)
+                                             int16_t y_value,
+                                             char (&command)[kMaxCommandLength + 1])
 {
-    String command = String(static_cast<char>(type));
-    command += "X";
-    command += String(x_value);
-    command += "Y";
-    command += String(y_value);
-    command += kMessageDelimiter;
+    // Sent every frame, formatted in place so the heap is never touched
+    size_t length = 0;
+    command[length++] = static_cast<char>(type);
+    command[length++] = 'X';
+    length += AppendDecimal(&command[length], x_value);
+    command[length++] = 'Y';
+    length += AppendDecimal(&command[length], y_value);
+    command[length++] = kMessageDelimiter;
+    command[length] = '\0';
 
-    return command;
+    return length;
+}
+
+size_t BluetoothTransmitter::AppendDecimal(char* buffer, int16_t value)
+{
+    size_t length = 0;
+    uint16_t magnitude = static_cast<uint16_t>(value);
+    if (value < 0)
+    {
+        buffer[length++] = '-';
+        magnitude = static_cast<uint16_t>(-static_cast<int32_t>(value));
+    }
+    char digits[5];
+    uint8_t count = 0;
+    do
+    {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (count > 0)
+    {
+        buffer[length++] = digits[--count];
+    }
+    return length;
 }
 
-bool BluetoothTransmitter::SendCommand(const String &command)
+bool BluetoothTransmitter::SendCommand(const char* command, size_t length)
 {
     if (!is_initialized_)
     {
@@ -151,21 +319,44 @@ bool BluetoothTransmitter::SendCommand(const String &command)
         return false;
     }
 
-    if (command.length() == 0 || command.length() > kMaxCommandLength)
+    // Do not fill serial buffer while nobody is listening
+    if (!IsConnected())
     {
-        LOG_WARNING("Error: Invalid command length");
         return false;
     }
 
-    // Send the command
-    serial_ble_->print(command);
+    if (!WriteCommand(command, length))
+    {
+        return false;
+    }
 
     // Update tracking variables
-    last_command_ = command;
+    memcpy(last_command_, command, length);
+    last_command_[length] = '\0';
+    return true;
+}
+
+bool BluetoothTransmitter::WriteCommand(const char* command, size_t length)
+{
+    if (length == 0 || length > kMaxCommandLength)
+    {
+        LOG_WARNING("Error: Invalid command length");
+        return false;
+    }
+
+    // Drop command instead of blocking until slow serial link drains TX buffer
+    if (serial_ble_->availableForWrite() < static_cast<int>(length))
+    {
+        return false;
+    }
+
+    // Send the command
+    serial_ble_->write(command, length);
     last_command_time_ = millis();
+    has_sent_command_ = true;
 
     // Debug output (optional)
-    LOG_DEBUG("Sent: %s", command.c_str());
+    LOG_DEBUG("Sent: %s", command);
 
     return true;
 }
@@ -186,3 +377,159 @@ bool BluetoothTransmitter::ValidatePadValues(int16_t x_value, int16_t y_value) c
 
     return true;
 }
+
+void BluetoothTransmitter::ReadResponses()
+{
+    int available = serial_ble_->available();
+    while (available-- > 0)
+    {
+        const int byte = serial_ble_->read();
+        if (byte < 0)
+        {
+            break;
+        }
+        const char c = static_cast<char>(byte);
+        const bool is_at_mode = link_state_ == BleLinkState::kSettingBaud ||
+                                link_state_ == BleLinkState::kVerifyingBaud;
+        if (c == kMessageDelimiter || c == '\r' || c == '\n')
+        {
+            if (rx_length_ > 0 && !is_at_mode)
+            {
+                HandleMessage();
+            }
+            rx_length_ = 0;
+            continue;
+        }
+        if (rx_length_ < kRxBufferSize - 1)
+        {
+            rx_buffer_[rx_length_++] = c;
+            rx_buffer_[rx_length_] = '\0';
+        }
+        // AT responses are not terminated, accept them as soon as they are recognized
+        if (is_at_mode && rx_length_ >= 2 && strncmp(rx_buffer_, "OK", 2) == 0)
+        {
+            rx_length_ = 0;
+            HandleAtResponse();
+        }
+    }
+}
+
+void BluetoothTransmitter::HandleMessage()
+{
+    last_rx_ms_ = millis();
+    switch (static_cast<ResponseType>(rx_buffer_[0]))
+    {
+        case ResponseType::kHeartbeat:
+            // Robot message parsed at target baud rate confirms it even if module ignored AT
+            is_baud_confirmed_ = true;
+            break;
+        case ResponseType::kAck:
+            is_baud_confirmed_ = true;
+            last_ack_ = rx_length_ > 1 ? rx_buffer_[1] : 0;
+            LOG_DEBUG("BLE ack: %c", last_ack_);
+            if (last_ack_ == static_cast<char>(CommandType::kPidBatch) &&
+                pid_batch_state_ == PidBatchState::kPending)
+            {
+                // Retried batch may be acknowledged twice, only the current sequence counts
+                const int sequence = rx_length_ >= 4 ? ParseHexByte(&rx_buffer_[2]) : -1;
+                if (sequence == pid_batch_sequence_)
+                {
+                    pid_batch_state_ = PidBatchState::kAcked;
+                    LOG_INFO("PID batch acknowledged");
+                }
+                else
+                {
+                    LOG_DEBUG("Stale PID batch ack: %d", sequence);
+                }
+            }
+            break;
+        default:
+            LOG_DEBUG("Unknown BLE message: %s", rx_buffer_);
+            break;
+    }
+    if (link_state_ == BleLinkState::kDisconnected && is_baud_confirmed_)
+    {
+        LOG_INFO("BLE link established");
+        SetLinkState(BleLinkState::kConnected);
+    }
+}
+
+int BluetoothTransmitter::ParseHexByte(const char* digits)
+{
+    int value = 0;
+    for (uint8_t i = 0; i < 2; ++i)
+    {
+        const char c = digits[i];
+        int nibble;
+        if (c >= '0' && c <= '9')
+        {
+            nibble = c - '0';
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            nibble = c - 'A' + 10;
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            nibble = c - 'a' + 10;
+        }
+        else
+        {
+            return -1;
+        }
+        value = (value << 4) | nibble;
+    }
+    return value;
+}
+
+void BluetoothTransmitter::StartBaudSetup()
+{
+    serial_ble_->end(); // Ensure any previous connection is closed
+    serial_ble_->begin(kBaudRate);
+    // TODO: Toggle EN pin when AT commands are send
+    serial_ble_->print("AT+BAUD3");
+    rx_length_ = 0;
+    ++baud_attempts_;
+    SetLinkState(BleLinkState::kSettingBaud);
+}
+
+void BluetoothTransmitter::HandleAtResponse()
+{
+    if (link_state_ == BleLinkState::kSettingBaud)
+    {
+        serial_ble_->end();
+        serial_ble_->begin(kTargetBaudRate);
+        serial_ble_->print("AT");
+        SetLinkState(BleLinkState::kVerifyingBaud);
+    }
+    else if (link_state_ == BleLinkState::kVerifyingBaud)
+    {
+        is_baud_confirmed_ = true;
+        LOG_INFO("BLE module baud rate confirmed: %l", kTargetBaudRate);
+        SetLinkState(BleLinkState::kDisconnected);
+    }
+}
+
+void BluetoothTransmitter::SetLinkState(BleLinkState state)
+{
+    link_state_ = state;
+    state_time_ms_ = millis();
+}
+
+void BluetoothTransmitter::UpdatePidBatch()
+{
+    if (pid_batch_state_ != PidBatchState::kPending ||
+        millis() - pid_batch_time_ms_ < kBatchAckTimeoutMs)
+    {
+        return;
+    }
+    if (pid_batch_retries_ >= kBatchMaxRetries || !IsConnected())
+    {
+        LOG_WARNING("PID batch not acknowledged");
+        pid_batch_state_ = PidBatchState::kFailed;
+        return;
+    }
+    ++pid_batch_retries_;
+    pid_batch_time_ms_ = millis();
+    WriteCommand(pid_batch_frame_, pid_batch_length_);
+}
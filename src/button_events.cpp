@@ -0,0 +1,86 @@
+#include "button_events.h"
+#include "log.h"
+
+ButtonEvents::ButtonEvents()
+    : state_(0),
+      counter_low_(0xFF),
+      counter_high_(0xFF),
+      long_press_sent_(0),
+      press_time_us_{},
+      combos_{},
+      combo_count_(0),
+      queue_(),
+      dropped_events_(0)
+{
+}
+
+void ButtonEvents::Update(uint8_t sample, uint32_t now_us)
+{
+    // Vertical counter: counters of unchanged bits are reset, changed bits count
+    // down and toggle debounced state on roll over
+    uint8_t changed = state_ ^ sample;
+    counter_low_ = ~(counter_low_ & changed);
+    counter_high_ = counter_low_ ^ (counter_high_ & changed);
+    changed &= counter_low_ & counter_high_;
+    const uint8_t previous_state = state_;
+    state_ ^= changed;
+
+    const uint8_t pressed = changed & state_;
+    const uint8_t released = changed & previous_state;
+    for (uint8_t i = 0; i < kButtonCount; ++i)
+    {
+        const uint8_t mask = static_cast<uint8_t>(1U << i);
+        if (pressed & mask)
+        {
+            press_time_us_[i] = now_us;
+            long_press_sent_ &= ~mask;
+            PushEvent(ButtonEventType::kPress, mask, now_us);
+        }
+        else if (released & mask)
+        {
+            PushEvent(ButtonEventType::kRelease, mask, now_us);
+        }
+        else if ((state_ & mask) && !(long_press_sent_ & mask) &&
+                 now_us - press_time_us_[i] >= kLongPressUs)
+        {
+            long_press_sent_ |= mask;
+            PushEvent(ButtonEventType::kLongPress, mask, now_us);
+        }
+    }
+
+    if (pressed)
+    {
+        for (uint8_t i = 0; i < combo_count_; ++i)
+        {
+            // Combo completes when its last button gets pressed
+            if ((state_ & combos_[i]) == combos_[i] && (pressed & combos_[i]))
+            {
+                PushEvent(ButtonEventType::kCombo, combos_[i], now_us);
+            }
+        }
+    }
+}
+
+bool ButtonEvents::PopEvent(ButtonEvent* event)
+{
+    return event != nullptr && queue_.pop(*event);
+}
+
+bool ButtonEvents::AddCombo(uint8_t mask)
+{
+    if (combo_count_ >= kMaxCombos || mask == 0)
+    {
+        LOG_WARNING("Unable to register button combo 0x%x", mask);
+        return false;
+    }
+    combos_[combo_count_++] = mask;
+    return true;
+}
+
+void ButtonEvents::PushEvent(ButtonEventType type, uint8_t buttons, uint32_t now_us)
+{
+    if (!queue_.push(ButtonEvent{now_us, type, buttons}) && dropped_events_ < 0xFF)
+    {
+        ++dropped_events_;
+    }
+}
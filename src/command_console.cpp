@@ -0,0 +1,299 @@
+#include "command_console.h"
+#include "log.h"
+
+namespace
+{
+struct ParamName {
+    const char* name;
+    ConsoleParam param;
+};
+
+constexpr ParamName kParamNames[] = {
+    {"pa", ConsoleParam::kPaLevel},
+    {"ch", ConsoleParam::kChannel},
+    {"rate", ConsoleParam::kLoopRate},
+    {"log", ConsoleParam::kLogLevel},
+    {"tx", ConsoleParam::kTransport},
+    {"cap", ConsoleParam::kCapture},
+    {"noack", ConsoleParam::kNoAck},
+    {"tdma", ConsoleParam::kTdma},
+    {"id", ConsoleParam::kControllerId},
+    {"pid1", ConsoleParam::kPidGain1},
+    {"pid2", ConsoleParam::kPidGain2},
+    {"pid3", ConsoleParam::kPidGain3},
+    {"pid4", ConsoleParam::kPidGain4},
+};
+
+struct CommandName {
+    const char* name;
+    char command;
+};
+
+constexpr CommandName kCommandNames[] = {
+    {"get", 'G'},
+    {"set", 'S'},
+    {"stats", 'T'},
+    {"cal", 'C'},
+    {"save", 'W'},
+};
+
+const char* ParamToString(ConsoleParam param) {
+    for (const auto& entry : kParamNames) {
+        if (entry.param == param) {
+            return entry.name;
+        }
+    }
+    return "?";
+}
+}
+
+CommandConsole::CommandConsole(Stream* serial, const ConsoleHandlers& handlers)
+    : serial_(serial),
+      handlers_(handlers),
+      line_{},
+      line_length_(0),
+      line_overflow_(false),
+      frame_{},
+      frame_length_(0),
+      frame_start_ms_(0),
+      is_muted_(false)
+{
+}
+
+void CommandConsole::Poll()
+{
+    // Resynchronize when binary frame was interrupted
+    if (frame_length_ > 0 && millis() - frame_start_ms_ > kBinaryFrameTimeoutMs)
+    {
+        frame_length_ = 0;
+    }
+
+    // Bounded by RX buffer size, bytes arriving meanwhile are handled on next poll
+    int available = serial_->available();
+    while (available-- > 0)
+    {
+        const int byte = serial_->read();
+        if (byte < 0)
+        {
+            break;
+        }
+        ProcessByte(static_cast<uint8_t>(byte));
+    }
+}
+
+void CommandConsole::ProcessByte(uint8_t byte)
+{
+    // Binary frame in progress or starting
+    if (frame_length_ > 0 || (byte == kBinarySync && line_length_ == 0))
+    {
+        if (frame_length_ == 0)
+        {
+            frame_start_ms_ = millis();
+        }
+        frame_[frame_length_++] = byte;
+        if (frame_length_ == kBinaryFrameSize)
+        {
+            ProcessBinaryFrame();
+            frame_length_ = 0;
+        }
+        return;
+    }
+
+    if (byte == '\r' || byte == '\n')
+    {
+        if (line_overflow_)
+        {
+            if (!is_muted_)
+            {
+                serial_->println(RAM_OPT("ERR too long"));
+            }
+        }
+        else if (line_length_ > 0)
+        {
+            line_[line_length_] = '\0';
+            ProcessLine();
+        }
+        line_length_ = 0;
+        line_overflow_ = false;
+        return;
+    }
+
+    if (line_length_ < kLineBufferSize - 1)
+    {
+        line_[line_length_++] = static_cast<char>(byte);
+    }
+    else
+    {
+        line_overflow_ = true;
+    }
+}
+
+void CommandConsole::ProcessLine()
+{
+    char* save_ptr = nullptr;
+    const char* command_name = strtok_r(line_, " ", &save_ptr);
+    const char* param_name = strtok_r(nullptr, " ", &save_ptr);
+    const char* value_str = strtok_r(nullptr, " ", &save_ptr);
+    if (command_name == nullptr)
+    {
+        return;
+    }
+
+    if (strcmp(command_name, "help") == 0)
+    {
+        if (is_muted_)
+        {
+            return;
+        }
+        serial_->println(RAM_OPT("get|set <pa|ch|rate|log|tx|cap|noack|tdma|id|pid1..4> [value], stats, cal, save"));
+        return;
+    }
+
+    char command = 0;
+    for (const auto& entry : kCommandNames)
+    {
+        if (strcmp(command_name, entry.name) == 0)
+        {
+            command = entry.command;
+            break;
+        }
+    }
+
+    ConsoleParam param = ConsoleParam::kPaLevel;
+    int32_t value = 0;
+    const bool needs_param = command == 'G' || command == 'S';
+    if (command == 0 ||
+        (needs_param && (param_name == nullptr || !ParseParam(param_name, &param))))
+    {
+        if (!is_muted_)
+        {
+            serial_->println(RAM_OPT("ERR unknown command"));
+        }
+        return;
+    }
+    if (command == 'S')
+    {
+        char* end = nullptr;
+        value = value_str != nullptr ? strtol(value_str, &end, 10) : 0;
+        if (value_str == nullptr || *end != '\0')
+        {
+            if (!is_muted_)
+            {
+                serial_->println(RAM_OPT("ERR invalid value"));
+            }
+            return;
+        }
+    }
+
+    const bool muted_before = is_muted_;
+    const bool ok = Execute(command, param, &value);
+    if (!CanRespond(muted_before))
+    {
+        return;
+    }
+    if (!ok)
+    {
+        serial_->println(RAM_OPT("ERR"));
+        return;
+    }
+    if (needs_param)
+    {
+        PrintParam(param, value);
+    }
+    else
+    {
+        serial_->println(RAM_OPT("OK"));
+    }
+}
+
+void CommandConsole::ProcessBinaryFrame()
+{
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < kBinaryFrameSize - 1; ++i)
+    {
+        checksum ^= frame_[i];
+    }
+
+    const char command = static_cast<char>(frame_[1]);
+    const auto param = static_cast<ConsoleParam>(frame_[2]);
+    int32_t value = static_cast<int16_t>(frame_[3] | (frame_[4] << 8));
+    const bool muted_before = is_muted_;
+    const bool ok = checksum == frame_[kBinaryFrameSize - 1] && Execute(command, param, &value);
+    if (!CanRespond(muted_before))
+    {
+        return;
+    }
+
+    uint8_t response[kBinaryFrameSize] = {
+        kBinarySync,
+        static_cast<uint8_t>(ok ? frame_[1] : frame_[1] | kBinaryErrorFlag),
+        frame_[2],
+        static_cast<uint8_t>(value & 0xFF),
+        static_cast<uint8_t>((value >> 8) & 0xFF),
+        0
+    };
+    for (size_t i = 1; i < kBinaryFrameSize - 1; ++i)
+    {
+        response[kBinaryFrameSize - 1] ^= response[i];
+    }
+    serial_->write(response, sizeof(response));
+}
+
+bool CommandConsole::Execute(char command, ConsoleParam param, int32_t* value)
+{
+    switch (command)
+    {
+        case 'G':
+            return handlers_.get_param != nullptr &&
+                   handlers_.get_param(handlers_.context, param, value);
+        case 'S':
+            if (handlers_.set_param == nullptr ||
+                !handlers_.set_param(handlers_.context, param, *value))
+            {
+                return false;
+            }
+            LOG_INFO("Console set %s to %l", ParamToString(param), *value);
+            return true;
+        case 'T':
+            // Stats are printed directly to stream
+            if (handlers_.dump_stats == nullptr || is_muted_)
+            {
+                return false;
+            }
+            handlers_.dump_stats(handlers_.context, serial_);
+            return true;
+        case 'C':
+            if (handlers_.start_calibration == nullptr)
+            {
+                return false;
+            }
+            handlers_.start_calibration(handlers_.context);
+            return true;
+        case 'W':
+            return handlers_.save_settings != nullptr &&
+                   handlers_.save_settings(handlers_.context);
+        default:
+            return false;
+    }
+}
+
+bool CommandConsole::ParseParam(const char* name, ConsoleParam* param)
+{
+    for (const auto& entry : kParamNames)
+    {
+        if (strcmp(name, entry.name) == 0)
+        {
+            *param = entry.param;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CommandConsole::PrintParam(ConsoleParam param, int32_t value)
+{
+    serial_->print(RAM_OPT("OK "));
+    serial_->print(ParamToString(param));
+    serial_->print(' ');
+    serial_->println(static_cast<long>(value));
+}
@@ -0,0 +1,93 @@
+#include "controller_table.h"
+#include "log.h"
+
+namespace
+{
+// Output published while link is lost: no controller connected, axes and buttons released
+constexpr BP32Data::PackedControllerData kNeutralData = {
+    -1, {0}, 0, {0}, 0, 0, 0, 0, 0, 0, 0, 0, {0, 0, 0}, {0, 0, 0}
+};
+constexpr uint8_t kAllSlots = static_cast<uint8_t>((1U << BP32Data::kMaxControllers) - 1);
+}
+
+BP32Data::ControllerTable::ControllerTable():
+        controllers_{},
+        last_seen_ms_{},
+        seen_mask_(0),
+        failsafe_mask_(kAllSlots),
+        recovery_count_{},
+        failsafe_config_(kDefaultFailsafeConfig) {
+    for (auto &controller : controllers_) {
+        controller.setControllerData(kNeutralData);
+    }
+}
+
+bool BP32Data::ControllerTable::update(uint8_t slot, const PackedControllerData &data, uint32_t now_ms) {
+    if (slot >= kMaxControllers) {
+        return false;
+    }
+    const uint8_t bit = static_cast<uint8_t>(1U << slot);
+    if (failsafe_mask_ & bit) {
+        // Frames have to arrive steadily again before output is trusted
+        const bool is_steady = (seen_mask_ & bit) && now_ms - last_seen_ms_[slot] <= failsafe_config_.timeout_ms;
+        recovery_count_[slot] = is_steady ? recovery_count_[slot] + 1 : 1;
+        last_seen_ms_[slot] = now_ms;
+        seen_mask_ |= bit;
+        if (recovery_count_[slot] < failsafe_config_.recovery_frames) {
+            return false;
+        }
+        failsafe_mask_ &= ~bit;
+        LOG_INFO("Controller %d recovered from failsafe", slot);
+    }
+    controllers_[slot].setControllerData(data);
+    last_seen_ms_[slot] = now_ms;
+    seen_mask_ |= bit;
+    return true;
+}
+
+uint8_t BP32Data::ControllerTable::updateFailsafe(uint32_t now_ms) {
+    uint8_t entered_mask = 0;
+    for (uint8_t slot = 0; slot < kMaxControllers; ++slot) {
+        const uint8_t bit = static_cast<uint8_t>(1U << slot);
+        if ((failsafe_mask_ & bit) || now_ms - last_seen_ms_[slot] <= failsafe_config_.timeout_ms) {
+            continue;
+        }
+        failsafe_mask_ |= bit;
+        recovery_count_[slot] = 0;
+        controllers_[slot].setControllerData(kNeutralData);
+        entered_mask |= bit;
+        LOG_WARNING("Controller %d link lost, failsafe active", slot);
+    }
+    return entered_mask;
+}
+
+bool BP32Data::ControllerTable::isFailsafe(uint8_t slot) const {
+    return slot >= kMaxControllers || (failsafe_mask_ & (1U << slot));
+}
+
+void BP32Data::ControllerTable::setFailsafeConfig(const FailsafeConfig &config) {
+    failsafe_config_ = config;
+    if (failsafe_config_.recovery_frames == 0) {
+        failsafe_config_.recovery_frames = 1;
+    }
+}
+
+const BP32Data::ControllerDataManager* BP32Data::ControllerTable::get(uint8_t slot) const {
+    if (slot >= kMaxControllers || !(seen_mask_ & (1U << slot))) {
+        return nullptr;
+    }
+    return &controllers_[slot];
+}
+
+bool BP32Data::ControllerTable::subscribe(uint8_t slot, uint16_t fields, ControllerChangeCallback callback,
+                                          void *context) {
+    return slot < kMaxControllers && controllers_[slot].subscribe(fields, callback, context);
+}
+
+uint32_t BP32Data::ControllerTable::lastSeenMs(uint8_t slot) const {
+    return slot < kMaxControllers ? last_seen_ms_[slot] : 0;
+}
+
+bool BP32Data::ControllerTable::isActive(uint8_t slot, uint32_t now_ms, uint32_t timeout_ms) const {
+    return get(slot) != nullptr && now_ms - last_seen_ms_[slot] <= timeout_ms;
+}
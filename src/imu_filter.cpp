@@ -0,0 +1,56 @@
+#include "imu_filter.h"
+
+namespace
+{
+// rad/s in Q16 per gyro count: pi / 180 / 65.5 * 65536 = 17.463
+constexpr int32_t kGyroRadQ16PerCount1000 = 17463;
+// 1e6 / 256, converts (rate >> 4) * (dt_us >> 4) to angle in Q16 rad
+constexpr int32_t kStepDivider = 3906;
+}
+
+Imu::ComplementaryFilter::ComplementaryFilter():
+        gravity_q_{},
+        rate_dps_{},
+        is_initialized_(false) {
+}
+
+void Imu::ComplementaryFilter::reset(const RawSample &sample) {
+    for (uint8_t i = 0; i < 3; ++i) {
+        gravity_q_[i] = (static_cast<int32_t>(sample.accel[i]) * 1000 / kAccelCountsPerG) * (1 << kGravityShift);
+        rate_dps_[i] = static_cast<int32_t>(sample.gyro[i]) * 10 / kGyroCountsPerDps10;
+    }
+    is_initialized_ = true;
+}
+
+void Imu::ComplementaryFilter::update(const RawSample &sample, uint32_t dt_us) {
+    if (!is_initialized_) {
+        reset(sample);
+        return;
+    }
+    if (dt_us > kMaxStepUs) {
+        dt_us = kMaxStepUs;
+    }
+
+    // Rotation angle of this step for each axis, rad in Q16
+    int32_t angle_q16[3];
+    for (uint8_t i = 0; i < 3; ++i) {
+        rate_dps_[i] = static_cast<int32_t>(sample.gyro[i]) * 10 / kGyroCountsPerDps10;
+        const int32_t rate_q16 = static_cast<int32_t>(sample.gyro[i]) * kGyroRadQ16PerCount1000 / 1000;
+        angle_q16[i] = (rate_q16 >> 4) * static_cast<int32_t>(dt_us >> 4) / kStepDivider;
+    }
+
+    // Gravity is fixed in world frame, so in body frame it rotates opposite to body: g' = g + g x angle
+    const int32_t gx = gravity_q_[0];
+    const int32_t gy = gravity_q_[1];
+    const int32_t gz = gravity_q_[2];
+    int32_t predicted[3];
+    predicted[0] = gx + ((gy * angle_q16[2] - gz * angle_q16[1]) >> 16);
+    predicted[1] = gy + ((gz * angle_q16[0] - gx * angle_q16[2]) >> 16);
+    predicted[2] = gz + ((gx * angle_q16[1] - gy * angle_q16[0]) >> 16);
+
+    // Pull prediction towards measured acceleration, removes gyro drift
+    for (uint8_t i = 0; i < 3; ++i) {
+        const int32_t measured = (static_cast<int32_t>(sample.accel[i]) * 1000 / kAccelCountsPerG) * (1 << kGravityShift);
+        gravity_q_[i] = predicted[i] + ((measured - predicted[i]) >> kFusionShift);
+    }
+}
@@ -0,0 +1,259 @@
+#include "imu_mpu6050.h"
+#include "log.h"
+#include "pin_config.h"
+
+#if defined(__AVR__) && defined(ENABLE_IMU)
+#include <avr/interrupt.h>
+#define IMU_USE_TWI
+#endif
+
+namespace
+{
+constexpr uint8_t kWhoAmIValue = 0x68;
+constexpr uint8_t kClockPllGyroX = 0x01;        // PWR_MGMT_1: wake up, gyro X PLL as clock
+constexpr uint8_t kDigitalLowPass44Hz = 0x03;   // CONFIG: DLPF ~44 Hz, 1 kHz sample rate
+constexpr uint8_t kGyroRange500Dps = 0x08;      // GYRO_CONFIG: +-500 deg/s
+constexpr uint8_t kAccelRange4G = 0x08;         // ACCEL_CONFIG: +-4 G
+constexpr uint8_t kGyroOffset = 8;              // gyro registers follow accel and temperature
+constexpr unsigned long kTwiClockHz = 400000UL;
+constexpr uint8_t kMaxRead = 14;
+
+// Transaction shared with TWI ISR: write tx bytes, then read rx bytes after repeated start
+struct TwiTransaction {
+    uint8_t address;
+    uint8_t tx[2];
+    uint8_t tx_length;
+    uint8_t tx_index;
+    uint8_t rx[kMaxRead];
+    uint8_t rx_length;
+    uint8_t rx_index;
+    bool is_reading;
+};
+
+volatile TwiTransaction twi;
+volatile bool twi_busy = false;
+volatile bool twi_failed = false;
+volatile bool sample_ready = false;
+volatile uint16_t twi_error_count = 0;
+
+#ifdef IMU_USE_TWI
+constexpr uint8_t kTwiControl = bit(TWINT) | bit(TWEN) | bit(TWIE);
+
+void twiStop(bool failed)
+{
+    TWCR = bit(TWINT) | bit(TWEN) | bit(TWSTO);
+    twi_failed = failed;
+    if (failed)
+    {
+        ++twi_error_count;
+    }
+    twi_busy = false;
+}
+
+void twiStart()
+{
+    twi.tx_index = 0;
+    twi.rx_index = 0;
+    twi.is_reading = false;
+    twi_failed = false;
+    twi_busy = true;
+    TWCR = kTwiControl | bit(TWSTA);
+}
+
+// Busy wait for transaction end, only used during initialization
+bool twiWait(uint32_t timeout_ms)
+{
+    const uint32_t start_ms = millis();
+    while (twi_busy)
+    {
+        if (millis() - start_ms > timeout_ms)
+        {
+            // Reset bus engine, stuck transaction would block every next one
+            TWCR = 0;
+            TWCR = bit(TWEN);
+            twi_busy = false;
+            ++twi_error_count;
+            return false;
+        }
+    }
+    return !twi_failed;
+}
+#endif
+}
+
+#ifdef IMU_USE_TWI
+// Each bus event advances the transaction by one step, loop code is never blocked
+ISR(TWI_vect)
+{
+    switch (TWSR & 0xF8)
+    {
+        case 0x08:  // start sent
+        case 0x10:  // repeated start sent
+            TWDR = static_cast<uint8_t>(twi.address << 1) | (twi.is_reading ? 1 : 0);
+            TWCR = kTwiControl;
+            break;
+        case 0x18:  // address + write acknowledged
+        case 0x28:  // data byte acknowledged
+            if (twi.tx_index < twi.tx_length)
+            {
+                TWDR = twi.tx[twi.tx_index++];
+                TWCR = kTwiControl;
+            }
+            else if (twi.rx_length > 0)
+            {
+                twi.is_reading = true;
+                TWCR = kTwiControl | bit(TWSTA);
+            }
+            else
+            {
+                twiStop(false);
+            }
+            break;
+        case 0x40:  // address + read acknowledged, ACK every byte except the last one
+            TWCR = kTwiControl | (twi.rx_length > 1 ? bit(TWEA) : 0);
+            break;
+        case 0x50:  // data byte received, ACK sent
+            twi.rx[twi.rx_index++] = TWDR;
+            TWCR = kTwiControl | (twi.rx_index + 1 < twi.rx_length ? bit(TWEA) : 0);
+            break;
+        case 0x58:  // last data byte received, NACK sent
+            twi.rx[twi.rx_index++] = TWDR;
+            sample_ready = twi.rx_length == kMaxRead;
+            twiStop(false);
+            break;
+        default:    // NACK or arbitration lost
+            twiStop(true);
+            break;
+    }
+}
+#endif
+
+ImuMpu6050::ImuMpu6050(uint8_t address):
+        address_(address),
+        is_initialized_(false)
+{
+}
+
+bool ImuMpu6050::Initialize()
+{
+#ifdef IMU_USE_TWI
+    // Internal pull-ups only help on short wires, modules usually have their own
+    pinMode(IMU_SDA_PIN, INPUT_PULLUP);
+    pinMode(IMU_SCL_PIN, INPUT_PULLUP);
+    TWSR = 0;   // prescaler 1
+    TWBR = static_cast<uint8_t>((F_CPU / kTwiClockHz - 16) / 2);
+    TWCR = bit(TWEN);
+    twi.address = address_;
+
+    uint8_t who_am_i = 0;
+    if (!ReadRegistersBlocking(kRegisterWhoAmI, &who_am_i, 1) || who_am_i != kWhoAmIValue)
+    {
+        LOG_ERROR("MPU-6050 not found, WHO_AM_I: 0x%x", who_am_i);
+        return false;
+    }
+    const bool is_configured =
+        WriteRegisterBlocking(kRegisterPowerManagement, kClockPllGyroX) &&
+        WriteRegisterBlocking(kRegisterConfig, kDigitalLowPass44Hz) &&
+        WriteRegisterBlocking(kRegisterGyroConfig, kGyroRange500Dps) &&
+        WriteRegisterBlocking(kRegisterAccelConfig, kAccelRange4G);
+    if (!is_configured)
+    {
+        LOG_ERROR("MPU-6050 configuration failed");
+        return false;
+    }
+    sample_ready = false;
+    is_initialized_ = true;
+    LOG_INFO("MPU-6050 initialized");
+    return true;
+#else
+    LOG_WARNING("MPU-6050 is not supported in this build");
+    return false;
+#endif
+}
+
+bool ImuMpu6050::StartRead()
+{
+#ifdef IMU_USE_TWI
+    if (!is_initialized_ || twi_busy)
+    {
+        return false;
+    }
+    twi.tx[0] = kRegisterAccelX;
+    twi.tx_length = 1;
+    twi.rx_length = kSampleRegisterCount;
+    twiStart();
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ImuMpu6050::GetSample(Imu::RawSample* sample)
+{
+    // Buffer is only written by ISR while transaction is in progress
+    if (sample == nullptr || twi_busy || !sample_ready)
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+        const uint8_t accel = i * 2;
+        const uint8_t gyro = kGyroOffset + i * 2;
+        sample->accel[i] = static_cast<int16_t>((twi.rx[accel] << 8) | twi.rx[accel + 1]);
+        sample->gyro[i] = static_cast<int16_t>((twi.rx[gyro] << 8) | twi.rx[gyro + 1]);
+    }
+    sample_ready = false;
+    return true;
+}
+
+uint16_t ImuMpu6050::GetErrorCount() const
+{
+    noInterrupts();
+    const uint16_t count = twi_error_count;
+    interrupts();
+    return count;
+}
+
+bool ImuMpu6050::WriteRegisterBlocking(uint8_t reg, uint8_t value)
+{
+#ifdef IMU_USE_TWI
+    twi.tx[0] = reg;
+    twi.tx[1] = value;
+    twi.tx_length = 2;
+    twi.rx_length = 0;
+    twiStart();
+    return twiWait(kTransactionTimeoutMs);
+#else
+    (void)reg;
+    (void)value;
+    return false;
+#endif
+}
+
+bool ImuMpu6050::ReadRegistersBlocking(uint8_t reg, uint8_t* buffer, uint8_t length)
+{
+#ifdef IMU_USE_TWI
+    if (buffer == nullptr || length == 0 || length > kMaxRead)
+    {
+        return false;
+    }
+    twi.tx[0] = reg;
+    twi.tx_length = 1;
+    twi.rx_length = length;
+    twiStart();
+    if (!twiWait(kTransactionTimeoutMs))
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < length; ++i)
+    {
+        buffer[i] = twi.rx[i];
+    }
+    return true;
+#else
+    (void)reg;
+    (void)buffer;
+    (void)length;
+    return false;
+#endif
+}
@@ -0,0 +1,100 @@
+#include "input_capture.h"
+
+namespace
+{
+constexpr uint16_t kAdcMask = 0x3FF;
+constexpr uint8_t kButtonsMask = 0x7F;
+constexpr uint8_t kYShift = 10;
+constexpr uint8_t kButtonsShift = 20;
+
+uint8_t Checksum(const uint8_t (&buffer)[InputCapture::kRecordSize])
+{
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < InputCapture::kRecordSize - 1; ++i)
+    {
+        checksum ^= buffer[i];
+    }
+    return checksum;
+}
+}
+
+InputCapture::InputCapture(Print* out)
+    : out_(out),
+      record_count_(0),
+      dropped_count_(0),
+      is_active_(false)
+{
+}
+
+void InputCapture::Start()
+{
+    record_count_ = 0;
+    dropped_count_ = 0;
+    is_active_ = out_ != nullptr;
+}
+
+void InputCapture::Stop()
+{
+    is_active_ = false;
+}
+
+bool InputCapture::Write(uint32_t time_us, const JoystickData& joystick, uint8_t buttons)
+{
+    if (!is_active_)
+    {
+        return true;
+    }
+    // Partial record would corrupt the stream, drop whole record instead of waiting for UART
+    if (out_->availableForWrite() < static_cast<int>(kRecordSize))
+    {
+        if (dropped_count_ < 0xFFFF)
+        {
+            ++dropped_count_;
+        }
+        return false;
+    }
+    uint8_t buffer[kRecordSize];
+    Encode(CaptureRecord{
+        time_us,
+        static_cast<uint16_t>(joystick.x_raw),
+        static_cast<uint16_t>(joystick.y_raw),
+        buttons
+    }, buffer);
+    out_->write(buffer, kRecordSize);
+    ++record_count_;
+    return true;
+}
+
+void InputCapture::Encode(const CaptureRecord& record, uint8_t (&buffer)[kRecordSize])
+{
+    const uint32_t inputs = (static_cast<uint32_t>(record.x_raw & kAdcMask)) |
+                            (static_cast<uint32_t>(record.y_raw & kAdcMask) << kYShift) |
+                            (static_cast<uint32_t>(record.buttons & kButtonsMask) << kButtonsShift);
+    buffer[0] = kRecordSync;
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        buffer[1 + i] = static_cast<uint8_t>(record.time_us >> (8 * i));
+        buffer[5 + i] = static_cast<uint8_t>(inputs >> (8 * i));
+    }
+    buffer[kRecordSize - 1] = Checksum(buffer);
+}
+
+bool InputCapture::Decode(const uint8_t (&buffer)[kRecordSize], CaptureRecord* record)
+{
+    if (record == nullptr || buffer[0] != kRecordSync || buffer[kRecordSize - 1] != Checksum(buffer))
+    {
+        return false;
+    }
+    uint32_t time_us = 0;
+    uint32_t inputs = 0;
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        time_us |= static_cast<uint32_t>(buffer[1 + i]) << (8 * i);
+        inputs |= static_cast<uint32_t>(buffer[5 + i]) << (8 * i);
+    }
+    record->time_us = time_us;
+    record->x_raw = inputs & kAdcMask;
+    record->y_raw = (inputs >> kYShift) & kAdcMask;
+    record->buttons = (inputs >> kButtonsShift) & kButtonsMask;
+    return true;
+}
@@ -0,0 +1,84 @@
+#include <Arduino.h>
+#include "input_mapping.h"
+#include "joystick_shield.h"
+
+namespace
+{
+using InputMapping::Profile;
+using InputMapping::AxisRule;
+
+// Rule is a constant expression, so gains and limits are compiled into the code
+template <const Profile &P, uint8_t I>
+inline int32_t evaluateAxis(const int32_t x, const int32_t y) {
+    constexpr AxisRule rule = P.axes[I];
+    const int32_t value = ((x * rule.gain_x + y * rule.gain_y) >> InputMapping::kGainShift) + rule.offset;
+    return constrain(value, static_cast<int32_t>(rule.min), static_cast<int32_t>(rule.max));
+}
+
+// Branch-free select: rule output is masked with all ones if button is pressed, zero otherwise
+template <const Profile &P, uint8_t I>
+inline uint16_t evaluateButton(const uint8_t mask) {
+    constexpr uint16_t buttons = P.buttons[I].buttons;
+    return buttons & static_cast<uint16_t>(-static_cast<int16_t>((mask >> I) & 1U));
+}
+
+template <const Profile &P, uint8_t I>
+inline uint8_t evaluateMisc(const uint8_t mask) {
+    constexpr uint8_t misc_buttons = P.buttons[I].misc_buttons;
+    return misc_buttons & static_cast<uint8_t>(-static_cast<int8_t>((mask >> I) & 1U));
+}
+
+template <const Profile &P>
+void applyProfileTable(BP32Data::PackedControllerData &data, const PadData &pad_data) {
+    const int32_t x = pad_data.joystick.x_calibrated;
+    const int32_t y = pad_data.joystick.y_calibrated;
+    data.axis_x = evaluateAxis<P, InputMapping::kAxisX>(x, y);
+    data.axis_y = evaluateAxis<P, InputMapping::kAxisY>(x, y);
+    data.axis_rx = evaluateAxis<P, InputMapping::kAxisRX>(x, y);
+    data.axis_ry = evaluateAxis<P, InputMapping::kAxisRY>(x, y);
+    data.brake = evaluateAxis<P, InputMapping::kBrake>(x, y);
+    data.throttle = evaluateAxis<P, InputMapping::kThrottle>(x, y);
+
+    const uint8_t mask = PackButtonStates(&pad_data.buttons);
+    data.buttons =
+        evaluateButton<P, 0>(mask) | evaluateButton<P, 1>(mask) | evaluateButton<P, 2>(mask) |
+        evaluateButton<P, 3>(mask) | evaluateButton<P, 4>(mask) | evaluateButton<P, 5>(mask) |
+        evaluateButton<P, 6>(mask);
+    data.misc_buttons =
+        evaluateMisc<P, 0>(mask) | evaluateMisc<P, 1>(mask) | evaluateMisc<P, 2>(mask) |
+        evaluateMisc<P, 3>(mask) | evaluateMisc<P, 4>(mask) | evaluateMisc<P, 5>(mask) |
+        evaluateMisc<P, 6>(mask);
+}
+
+static_assert(ButtonMask::kButtonCount == 7, "applyProfileTable expects 7 physical buttons");
+
+using ApplyFunction = void (*)(BP32Data::PackedControllerData &, const PadData &);
+
+// Indexed by ProfileId, profile switch is a single indirect call
+constexpr ApplyFunction kApplyFunctions[] = {
+    &applyProfileTable<InputMapping::Profiles::kArcade>,
+    &applyProfileTable<InputMapping::Profiles::kTank>,
+    &applyProfileTable<InputMapping::Profiles::kCamera>,
+};
+static_assert(sizeof(kApplyFunctions) / sizeof(kApplyFunctions[0]) ==
+              static_cast<size_t>(InputMapping::ProfileId::kCount), "Missing profile function");
+}
+
+void InputMapping::applyProfile(ProfileId profile, BP32Data::PackedControllerData &data, const PadData &pad_data) {
+    const auto index = static_cast<uint8_t>(profile);
+    kApplyFunctions[index < static_cast<uint8_t>(ProfileId::kCount) ? index : 0](data, pad_data);
+}
+
+InputMapping::ProfileId InputMapping::nextProfile(ProfileId profile) {
+    const uint8_t next = static_cast<uint8_t>(profile) + 1;
+    return next < static_cast<uint8_t>(ProfileId::kCount) ? static_cast<ProfileId>(next) : ProfileId::kArcade;
+}
+
+const char* InputMapping::profileToString(ProfileId profile) {
+    switch (profile) {
+        case ProfileId::kArcade: return "ARCADE";
+        case ProfileId::kTank:   return "TANK";
+        case ProfileId::kCamera: return "CAMERA";
+        default:                 return "UNKNOWN";
+    }
+}
@@ -0,0 +1,103 @@
+#include <Arduino.h>
+#include "input_smoother.h"
+
+namespace
+{
+using BP32Data::PackedControllerData;
+
+// Axis fields in InputMapping::AxisOutput order
+constexpr int32_t PackedControllerData::* kAxisFields[] = {
+    &PackedControllerData::axis_x,
+    &PackedControllerData::axis_y,
+    &PackedControllerData::axis_rx,
+    &PackedControllerData::axis_ry,
+    &PackedControllerData::brake,
+    &PackedControllerData::throttle,
+};
+static_assert(sizeof(kAxisFields) / sizeof(kAxisFields[0]) == InputMapping::kAxisOutputCount,
+              "Missing axis field");
+
+bool isPedal(uint8_t axis) {
+    return axis == InputMapping::kBrake || axis == InputMapping::kThrottle;
+}
+}
+
+InputSmoother::InputSmoother(const SmoothingConfig &config):
+        config_(config),
+        previous_{},
+        latest_{},
+        previous_time_ms_(0),
+        latest_time_ms_(0),
+        frame_count_(0) {
+}
+
+void InputSmoother::addFrame(const BP32Data::PackedControllerData &data, uint32_t now_ms) {
+    if (data.id < 0 || (frame_count_ > 0 && latest_.id < 0)) {
+        // Never extrapolate into or out of failsafe output, first frame after it starts new history
+        restartHistory(data, now_ms);
+        return;
+    }
+    previous_ = latest_;
+    previous_time_ms_ = latest_time_ms_;
+    latest_ = data;
+    latest_time_ms_ = now_ms;
+    if (frame_count_ < 2) {
+        ++frame_count_;
+    }
+}
+
+void InputSmoother::restartHistory(const BP32Data::PackedControllerData &data, uint32_t now_ms) {
+    previous_ = data;
+    latest_ = data;
+    previous_time_ms_ = now_ms;
+    latest_time_ms_ = now_ms;
+    frame_count_ = 1;
+}
+
+bool InputSmoother::sample(uint32_t now_ms, BP32Data::PackedControllerData &data) const {
+    if (frame_count_ == 0) {
+        return false;
+    }
+    data = latest_;
+    if (frame_count_ < 2 || latest_.id < 0) {
+        return true;
+    }
+    for (uint8_t axis = 0; axis < InputMapping::kAxisOutputCount; ++axis) {
+        data.*kAxisFields[axis] = smoothAxis(axis, now_ms);
+    }
+    return true;
+}
+
+void InputSmoother::setConfig(const SmoothingConfig &config) {
+    config_ = config;
+}
+
+int32_t InputSmoother::smoothAxis(uint8_t axis, uint32_t now_ms) const {
+    const int32_t latest = latest_.*kAxisFields[axis];
+    const int32_t previous = previous_.*kAxisFields[axis];
+    const uint32_t interval_ms = latest_time_ms_ - previous_time_ms_;
+    if (interval_ms == 0) {
+        return latest;
+    }
+    uint32_t elapsed_ms = now_ms - latest_time_ms_;
+    int32_t value = latest;
+    switch (config_.axes[axis]) {
+        case AxisSmoothing::kInterpolate: {
+            // Output runs one interval behind, it moves from previous to latest during the interval
+            elapsed_ms = min(elapsed_ms, interval_ms);
+            const int32_t fraction = static_cast<int32_t>((elapsed_ms << kFractionShift) / interval_ms);
+            value = previous + (((latest - previous) * fraction) >> kFractionShift);
+            break;
+        }
+        case AxisSmoothing::kExtrapolate: {
+            elapsed_ms = min(elapsed_ms, static_cast<uint32_t>(config_.extrapolation_horizon_ms));
+            const int32_t fraction = static_cast<int32_t>((elapsed_ms << kFractionShift) / interval_ms);
+            value = latest + (((latest - previous) * fraction) >> kFractionShift);
+            break;
+        }
+        default:
+            return latest;
+    }
+    return isPedal(axis) ? constrain(value, static_cast<int32_t>(InputMapping::kPedalMin), static_cast<int32_t>(InputMapping::kPedalMax))
+                         : constrain(value, static_cast<int32_t>(InputMapping::kAxisMin), static_cast<int32_t>(InputMapping::kAxisMax));
+}
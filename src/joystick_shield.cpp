@@ -13,13 +13,12 @@ constexpr int kAnalogMinValue = 0;     ///< Minimum analog read value
 constexpr int kAnalogMaxValue = 1023;  ///< Maximum analog read value
 constexpr int kAnalogCenterValue = 512; ///< Approximate center value
 
-constexpr int kButtonPressed = LOW;    ///< Button state when pressed (pull-up configuration)
-constexpr int kButtonReleased = HIGH;  ///< Button state when released
 
 constexpr int kDeadZoneThreshold = 100;        ///< Threshold from center to consider as movement
 constexpr int kCalibrationButtonHoldTime = 3000;    ///< Time to hold button for calibration (ms)
 constexpr unsigned long kCalibrationSamples = 5;  ///< Number of samples for calibration
-constexpr unsigned long kCalibrationDelayMs = 10;   ///< Delay between calibration samples
+constexpr uint32_t kCalibrationSweepTimeoutMs = 15000; ///< Sweep is finished automatically after this time
+constexpr int kCalibrationSweepMinRange = 200;      ///< Minimum travel from center required on each side
 
 
 /**
@@ -27,13 +26,25 @@ constexpr unsigned long kCalibrationDelayMs = 10;   ///< Delay between calibrati
  */
 void JoystickShieldSetup() {
     // Configure joystick button and control buttons with pull-up resistors
-    pinMode(JOYSTICK_BUTTON_PIN, INPUT_PULLUP);
-    pinMode(A_PIN, INPUT_PULLUP);
-    pinMode(B_PIN, INPUT_PULLUP);
-    pinMode(C_PIN, INPUT_PULLUP);
-    pinMode(D_PIN, INPUT_PULLUP);
-    pinMode(E_PIN, INPUT_PULLUP);
-    pinMode(F_PIN, INPUT_PULLUP);
+    Hal::inputPullup<Board::JoystickButton>();
+    Hal::inputPullup<Board::ButtonA>();
+    Hal::inputPullup<Board::ButtonB>();
+    Hal::inputPullup<Board::ButtonC>();
+    Hal::inputPullup<Board::ButtonD>();
+    Hal::inputPullup<Board::ButtonE>();
+    Hal::inputPullup<Board::ButtonF>();
+}
+
+/**
+ * @brief Samples all buttons at once
+ * @return Packed mask using ButtonMask bits, bit set means pressed
+ */
+uint8_t ReadButtonMask() {
+    // Pin order follows ButtonMask bits, buttons pull pins low when pressed
+    const uint8_t levels = Hal::readMask<Board::ButtonA, Board::ButtonB, Board::ButtonC, Board::ButtonD,
+                                         Board::ButtonE, Board::ButtonF, Board::JoystickButton>();
+    static_assert(ButtonMask::kJoystickButton == 1U << 6, "Pin order must match ButtonMask");
+    return static_cast<uint8_t>(~levels) & static_cast<uint8_t>((1U << ButtonMask::kButtonCount) - 1);
 }
 
 /**
@@ -43,50 +54,168 @@ void JoystickShieldSetup() {
 void ReadButtonStates(ButtonStates* states) {
     if (states == nullptr) return;
 
-    states->joystick_button = (digitalRead(JOYSTICK_BUTTON_PIN) == kButtonPressed);
-    states->button_a = (digitalRead(A_PIN) == kButtonPressed);
-    states->button_b = (digitalRead(B_PIN) == kButtonPressed);
-    states->button_c = (digitalRead(C_PIN) == kButtonPressed);
-    states->button_d = (digitalRead(D_PIN) == kButtonPressed);
-    states->button_e = (digitalRead(E_PIN) == kButtonPressed);
-    states->button_f = (digitalRead(F_PIN) == kButtonPressed);
+    UnpackButtonStates(ReadButtonMask(), states);
 }
 
 /**
- * @brief Performs auto-calibration of the joystick
- * @param cal_data Pointer to CalibrationData structure to fill
+ * @brief Packs button states into single mask, bit set means pressed
+ * @param states Pointer to ButtonStates structure
+ * @return Packed mask using ButtonMask bits
  */
-void CalibrateJoystick(CalibrationData* cal_data) {
-    if (cal_data == nullptr) return;
+uint8_t PackButtonStates(const ButtonStates* states) {
+    if (states == nullptr) return 0;
+
+    return (states->button_a ? ButtonMask::kButtonA : 0) |
+           (states->button_b ? ButtonMask::kButtonB : 0) |
+           (states->button_c ? ButtonMask::kButtonC : 0) |
+           (states->button_d ? ButtonMask::kButtonD : 0) |
+           (states->button_e ? ButtonMask::kButtonE : 0) |
+           (states->button_f ? ButtonMask::kButtonF : 0) |
+           (states->joystick_button ? ButtonMask::kJoystickButton : 0);
+}
+
+/**
+ * @brief Unpacks button mask into button states
+ * @param mask Packed mask using ButtonMask bits
+ * @param states Pointer to ButtonStates structure to fill
+ */
+void UnpackButtonStates(uint8_t mask, ButtonStates* states) {
+    if (states == nullptr) return;
+
+    states->button_a = mask & ButtonMask::kButtonA;
+    states->button_b = mask & ButtonMask::kButtonB;
+    states->button_c = mask & ButtonMask::kButtonC;
+    states->button_d = mask & ButtonMask::kButtonD;
+    states->button_e = mask & ButtonMask::kButtonE;
+    states->button_f = mask & ButtonMask::kButtonF;
+    states->joystick_button = mask & ButtonMask::kJoystickButton;
+}
+
+/**
+ * @brief Starts center calibration which takes one sample per loop tick
+ * @param calibration Pointer to CenterCalibration state to reset
+ */
+void StartCenterCalibration(CenterCalibration* calibration) {
+    if (calibration == nullptr) return;
+
+    calibration->x_sum = 0;
+    calibration->y_sum = 0;
+    calibration->samples = 0;
+}
+
+/**
+ * @brief Adds one sample to center calibration, calibration completes after kCalibrationSamples ticks
+ * @param calibration Pointer to CenterCalibration state
+ * @param data Pointer to joystick data read in current tick
+ * @param cal_data Pointer to CalibrationData filled when enough samples were collected
+ * @return True once calibration is complete
+ */
+bool UpdateCenterCalibration(CenterCalibration* calibration, const JoystickData* data, CalibrationData* cal_data) {
+    if (calibration == nullptr || data == nullptr || cal_data == nullptr) return false;
+
+    calibration->x_sum += data->x_raw;
+    calibration->y_sum += data->y_raw;
+    if (++calibration->samples < kCalibrationSamples) {
+        return false;
+    }
 
-    // Initialize calibration values
     cal_data->x_min = kAnalogMinValue;
     cal_data->x_max = kAnalogMaxValue;
     cal_data->y_min = kAnalogMinValue;
     cal_data->y_max = kAnalogMaxValue;
+    cal_data->x_center = calibration->x_sum / kCalibrationSamples;
+    cal_data->y_center = calibration->y_sum / kCalibrationSamples;
+    cal_data->calibrated = true;
 
-    int32_t x_sum = 0;
-    int32_t y_sum = 0;
-
-    // Collect calibration samples
-    for (unsigned int i = 0; i < kCalibrationSamples; i++) {
-        int x_val = analogRead(JOYSTICK_X_PIN);
-        int y_val = analogRead(JOYSTICK_Y_PIN);
+    LOG_INFO("Calibration complete");
+    PrintCalibrationData(cal_data);
+    return true;
+}
 
-        // Sum for center calculation
-        x_sum += x_val;
-        y_sum += y_val;
+/**
+ * @brief Detects calibration button combo (E + F) held for kCalibrationButtonHoldTime
+ * @param sweep Pointer to CalibrationSweep holding combo timing
+ * @param states Pointer to current button states
+ * @return True once per combo press, when hold time elapses
+ */
+bool CheckCalibrationCombo(CalibrationSweep* sweep, const ButtonStates* states) {
+    if (sweep == nullptr || states == nullptr) return false;
 
-        delay(kCalibrationDelayMs);
+    if (!(states->button_e && states->button_f)) {
+        sweep->combo_since_ms = 0;
+        sweep->combo_handled = false;
+        return false;
+    }
+    const uint32_t now = millis();
+    if (sweep->combo_since_ms == 0) {
+        sweep->combo_since_ms = now | 1UL;  // 0 is reserved for released combo
+        return false;
+    }
+    if (!sweep->combo_handled && now - sweep->combo_since_ms >= kCalibrationButtonHoldTime) {
+        sweep->combo_handled = true;
+        return true;
     }
+    return false;
+}
 
-    // Calculate center values
-    cal_data->x_center = x_sum / kCalibrationSamples;
-    cal_data->y_center = y_sum / kCalibrationSamples;
-    cal_data->calibrated = true;
+/**
+ * @brief Starts full range calibration sweep, joystick must be centered
+ * @param sweep Pointer to CalibrationSweep to initialize
+ * @param data Pointer to current joystick data used as center
+ */
+void StartCalibrationSweep(CalibrationSweep* sweep, const JoystickData* data) {
+    if (sweep == nullptr || data == nullptr) return;
+
+    sweep->data.x_center = data->x_raw;
+    sweep->data.y_center = data->y_raw;
+    sweep->data.x_min = sweep->data.x_max = data->x_raw;
+    sweep->data.y_min = sweep->data.y_max = data->y_raw;
+    sweep->data.calibrated = false;
+    sweep->start_ms = millis();
+    sweep->active = true;
+    LOG_INFO("Calibration sweep started, move joystick to all edges");
+}
 
-    LOG_INFO("Calibration complete");
+/**
+ * @brief Extends learned ranges with current joystick position
+ * @param sweep Pointer to active CalibrationSweep
+ * @param data Pointer to current joystick data
+ * @return False when sweep timed out and should be finished
+ */
+bool UpdateCalibrationSweep(CalibrationSweep* sweep, const JoystickData* data) {
+    if (sweep == nullptr || data == nullptr || !sweep->active) return false;
+
+    sweep->data.x_min = min(sweep->data.x_min, data->x_raw);
+    sweep->data.x_max = max(sweep->data.x_max, data->x_raw);
+    sweep->data.y_min = min(sweep->data.y_min, data->y_raw);
+    sweep->data.y_max = max(sweep->data.y_max, data->y_raw);
+    return millis() - sweep->start_ms < kCalibrationSweepTimeoutMs;
+}
+
+/**
+ * @brief Finishes calibration sweep and applies learned ranges if they are valid
+ * @param sweep Pointer to active CalibrationSweep
+ * @param cal_data Pointer to CalibrationData updated on success
+ * @return True if learned ranges were applied
+ */
+bool FinishCalibrationSweep(CalibrationSweep* sweep, CalibrationData* cal_data) {
+    if (sweep == nullptr || cal_data == nullptr || !sweep->active) return false;
+
+    sweep->active = false;
+    const CalibrationData& learned = sweep->data;
+    if (learned.x_center - learned.x_min < kCalibrationSweepMinRange ||
+        learned.x_max - learned.x_center < kCalibrationSweepMinRange ||
+        learned.y_center - learned.y_min < kCalibrationSweepMinRange ||
+        learned.y_max - learned.y_center < kCalibrationSweepMinRange) {
+        LOG_WARNING("Calibration sweep range too small, keeping previous calibration");
+        PrintCalibrationData(&learned);
+        return false;
+    }
+    *cal_data = learned;
+    cal_data->calibrated = true;
+    LOG_INFO("Calibration sweep complete");
     PrintCalibrationData(cal_data);
+    return true;
 }
 
 /**
@@ -98,8 +227,18 @@ void ReadJoystickData(JoystickData* data, const CalibrationData* cal_data) {
     if (data == nullptr) return;
 
     // Read raw values
-    data->x_raw = analogRead(JOYSTICK_X_PIN);
-    data->y_raw = analogRead(JOYSTICK_Y_PIN);
+    data->x_raw = Hal::readAdc<Board::JoystickX>();
+    data->y_raw = Hal::readAdc<Board::JoystickY>();
+    ApplyJoystickCalibration(data, cal_data);
+}
+
+/**
+ * @brief Computes calibrated values and directions from raw values already stored in data
+ * @param data Joystick data with raw values, e.g. read from ADC or replayed from capture
+ * @param cal_data Calibration data, raw values are only centered if not calibrated
+ */
+void ApplyJoystickCalibration(JoystickData* data, const CalibrationData* cal_data) {
+    if (data == nullptr) return;
 
     // Apply calibration if available
     if (cal_data != nullptr && cal_data->calibrated) {
@@ -138,7 +277,7 @@ void ReadJoystickData(JoystickData* data, const CalibrationData* cal_data) {
  * @param is_vertical True if checking vertical axis, false for horizontal
  * @return JoystickDirection enum value
  */
-JoystickDirection GetJoystickDirection(int analog_value, int center_value, bool is_vertical = false) {
+JoystickDirection GetJoystickDirection(int analog_value, int center_value, bool is_vertical) {
     if (analog_value < (center_value - kDeadZoneThreshold)) {
         return is_vertical ? JoystickDirection::kDown : JoystickDirection::kLeft;
     } else if (analog_value > (center_value + kDeadZoneThreshold)) {
@@ -6,19 +6,57 @@
 #include "nrf24_driver.h"
 #include "gamepad_struct_converter.h"
 #include "bluetooth_transmitter.h"
+#include "power_manager.h"
+#include "battery_monitor.h"
+#include "settings_store.h"
+#include "command_console.h"
+#include "button_events.h"
+#include "transport_dispatcher.h"
+#include "imu_mpu6050.h"
+#include "input_capture.h"
+#include "memory_diagnostics.h"
+
+// Serial console shares UART with BLE module
+#if defined(ENABLE_SERIAL_CONSOLE) && !defined(ENABLE_BLE_SERIAL)
+#define USE_SERIAL_CONSOLE
+#endif
 
 // Global data structures
 JoystickData joystick_data;
 ButtonStates button_states;
 CalibrationData calibration_data;
+CalibrationSweep calibration_sweep;
+CenterCalibration boot_calibration;
+Settings settings;
+BP32Data::PackedControllerData controller_data{};
+// Transport selection policy
+enum class TransportPolicy : uint8_t {
+    kSwitch,    // SWITCH_TRANSMISSION_MODE_PIN selects BLE (LOW) or radio (HIGH)
+    kRadio,     // radio only
+    kBle,       // BLE only
+    kBoth,      // radio and BLE at the same time
+    kCount
+};
+
 // Global variables
 bool is_bluetooth_mode = false;
+TransportPolicy transport_policy = TransportPolicy::kSwitch;
+uint8_t radio_transport = 0;    // dispatcher bit of radio transport
+uint8_t ble_transport = 0;      // dispatcher bit of BLE transport, 0 if BLE is not built in
+bool is_shutdown = false;
+bool is_boot_calibration = false;    // center calibration runs in first loop ticks
+uint32_t first_frame_us = 0;   // micros() of first frame sent after boot, 0 until then
+InputMapping::ProfileId input_profile = InputMapping::ProfileId::kArcade;
+#ifdef ENABLE_IMU
+Imu::ComplementaryFilter imu_filter;
+uint32_t imu_sample_time_us = 0;
+#endif
 
 //use single static instance of nrf24l01 driver
 inline RF24Driver::NRF24Controller& getNRF24ControllerInstance() {
     static RF24Driver::NRF24Controller nrf24_controller(
-        NRF24L01_CE_PIN,
-        NRF24L01_CSN_PIN
+        Board::Radio::CePin::kNumber,
+        Board::Radio::CsnPin::kNumber
     );
     return nrf24_controller;
 }
@@ -28,25 +66,406 @@ inline BluetoothTransmitter& getBluetoothTransmitterInstance() {
     return bluetooth_transmitter;
 }
 
-bool checkBatteryVoltage() {
-#ifdef ENABLE_LOW_VOLTAGE_PROTECTION
-    // Read the voltage from the voltage monitor pin
-    int sensorValue = analogRead(VOLTAGE_MONITOR_PIN);
-    // Convert the analog reading to voltage (assuming a 5.0V reference)
-    float voltage = sensorValue * (5.0 / 1023.0);
-    LOG_DEBUG("Battery voltage: %F V", voltage);
-    // Check if the voltage is below a certain threshold
-    return voltage < 3.4 && voltage > 0.8;
-#else
-    return false;
+inline TransportDispatcher& getTransportDispatcherInstance() {
+    static TransportDispatcher transport_dispatcher;
+    return transport_dispatcher;
+}
+
+inline PowerManager& getPowerManagerInstance() {
+    static PowerManager power_manager(kMainLoopCycleTimeUs);
+    return power_manager;
+}
+
+inline ButtonEvents& getButtonEventsInstance() {
+    static ButtonEvents button_events;
+    return button_events;
+}
+
+inline SettingsStore& getSettingsStoreInstance() {
+    static SettingsStore settings_store;
+    return settings_store;
+}
+
+inline BatteryMonitor& getBatteryMonitorInstance() {
+    static BatteryMonitor battery_monitor(VOLTAGE_MONITOR_PIN);
+    return battery_monitor;
+}
+
+#ifdef ENABLE_IMU
+inline ImuMpu6050& getImuInstance() {
+    static ImuMpu6050 imu;
+    return imu;
+}
+
+// Fuse sample read during last tick and start read of the next one
+void updateImu() {
+    auto& imu = getImuInstance();
+    Imu::RawSample sample;
+    if (imu.GetSample(&sample)) {
+        const uint32_t now_us = micros();
+        imu_filter.update(sample, now_us - imu_sample_time_us);
+        imu_sample_time_us = now_us;
+        for (uint8_t i = 0; i < 3; ++i) {
+            controller_data.gyro[i] = imu_filter.rateDps(i);        // deg/s
+            controller_data.accel[i] = imu_filter.gravityMg(i);     // filtered gravity in milli-G
+        }
+    }
+    imu.StartRead();
+}
+#endif
+
+// Main loop period for current settings and battery state
+uint32_t getLoopPeriodUs() {
+    const uint32_t period_us = 1000000UL / constrain(settings.loop_rate_hz, kMinLoopRateHz, kMaxLoopRateHz);
+    if (getBatteryMonitorInstance().GetState() == BatteryState::kNormal) {
+        return period_us;
+    }
+    return max(period_us, kLowBatteryLoopCycleTimeUs);
+}
+
+// Select transports from policy and transmission mode switch
+uint8_t getActiveTransports() {
+    switch (transport_policy) {
+        case TransportPolicy::kRadio: return radio_transport;
+        case TransportPolicy::kBle:   return ble_transport;
+        case TransportPolicy::kBoth:  return radio_transport | ble_transport;
+        default:
+            // Without BLE support switch can not turn radio off
+            return (is_bluetooth_mode && ble_transport != 0) ? ble_transport : radio_transport;
+    }
+}
+
+// Send neutral frame marked as disconnected so receiver stops acting on last input
+void sendDyingFrame() {
+    BP32Data::PackedControllerData dying_frame{};
+    dying_frame.id = -1;
+    auto& nrf24 = getNRF24ControllerInstance();
+    for (int i = 0; i < kDyingFrameRepeatCount; ++i) {
+        nrf24.sendGamepadData(dying_frame);
+    }
+    nrf24.powerDown();
+}
+
+// Apply PA level of settings, critical battery keeps the radio at minimum power
+bool applyPaLevel() {
+    const bool is_critical = getBatteryMonitorInstance().GetState() == BatteryState::kCritical;
+    return getNRF24ControllerInstance().setPALevel(
+        is_critical ? static_cast<uint8_t>(RF24_PA_MIN) : settings.pa_level);
+}
+
+// Degrade controller features step by step as battery discharges
+void applyBatteryState(const BatteryState state) {
+    auto& power_manager = getPowerManagerInstance();
+    if (state == BatteryState::kDying) {
+        Hal::write<Board::LowVoltageLed>(true);
+        LOG_WARNING("Battery is empty, controller shut down");
+        sendDyingFrame();
+        power_manager.SetTickPeriod(kShutdownLoopCycleTimeUs);
+        is_shutdown = true;
+        return;
+    }
+    power_manager.SetTickPeriod(getLoopPeriodUs());
+    applyPaLevel();
+#ifdef ENABLE_BLE_SERIAL
+    auto& bluetooth = getBluetoothTransmitterInstance();
+    if (state == BatteryState::kCritical) {
+        bluetooth.Shutdown();
+    } else if (!bluetooth.IsInitialized()) {
+        bluetooth.Initialize();
+    }
+#endif
+}
+
+#ifdef ENABLE_BLE_SERIAL
+// PID gains are sent once per BLE link, a reconnect may mean the robot was reset
+bool is_pid_gains_sent = false;
+
+// Send gains selected in settings as one acknowledged batch when BLE link comes up
+void sendStoredPidGains() {
+    static constexpr CommandType kPidGainTypes[kPidGainCount] = {
+        CommandType::kPidSetting1, CommandType::kPidSetting2, CommandType::kPidSetting3, CommandType::kPidSetting4
+    };
+    auto& bluetooth = getBluetoothTransmitterInstance();
+    if (!bluetooth.IsConnected()) {
+        is_pid_gains_sent = false;
+        return;
+    }
+    if (is_pid_gains_sent || settings.pid_gain_mask == 0) {
+        return;
+    }
+    PidParameter params[kPidGainCount];
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < kPidGainCount; ++i) {
+        if (settings.pid_gain_mask & (1U << i)) {
+            params[count++] = PidParameter{kPidGainTypes[i], settings.pid_gains_q8[i]};
+        }
+    }
+    is_pid_gains_sent = bluetooth.SendPidBatch(params, count);
+}
+#endif
+
+// Status LED: solid when controller battery is low, blinking when robot reports low battery
+void updateStatusLed() {
+    const bool controller_low = getBatteryMonitorInstance().GetState() != BatteryState::kNormal;
+    RF24Driver::Telemetry telemetry;
+    const bool robot_low = getNRF24ControllerInstance().getTelemetry(telemetry) &&
+                           telemetry.battery_mv < kRobotBatteryLowMv;
+    const bool blink_on = (millis() / kStatusLedBlinkPeriodMs) & 1U;
+    Hal::write<Board::LowVoltageLed>(controller_low || (robot_low && blink_on));
+}
+
+// Apply finished calibration sweep and persist it
+void finishCalibrationSweep() {
+    if (FinishCalibrationSweep(&calibration_sweep, &calibration_data)) {
+        settings.calibration = calibration_data;
+        getSettingsStoreInstance().Save(settings);
+    }
+}
+
+// Stick is pushed to every edge during calibration sweep and E + F controls the sweep,
+// robot gets centered axes and released buttons instead while the link stays up
+bool isCalibrationInput() {
+    return calibration_sweep.active || calibration_sweep.combo_since_ms != 0;
+}
+
+void setNeutralInput(BP32Data::PackedControllerData &data) {
+    data.dpad = 0;
+    data.axis_x = 0;
+    data.axis_y = 0;
+    data.axis_rx = 0;
+    data.axis_ry = 0;
+    data.brake = 0;
+    data.throttle = 0;
+    data.buttons = 0;
+    data.misc_buttons = 0;
+}
+
+// Handle momentary button actions on debounced edges
+void processButtonEvents() {
+    auto& button_events = getButtonEventsInstance();
+    ButtonEvent event;
+    while (button_events.PopEvent(&event)) {
+        LOG_DEBUG("Button event %d, buttons: 0x%x, time: %l us",
+                  static_cast<int>(event.type), event.buttons, event.time_us);
+        // C + D switches input mapping profile
+        if (event.type == ButtonEventType::kCombo &&
+            event.buttons == (ButtonMask::kButtonC | ButtonMask::kButtonD)) {
+            input_profile = InputMapping::nextProfile(input_profile);
+            LOG_INFO("Input profile: %s", InputMapping::profileToString(input_profile));
+        }
+#ifdef ENABLE_BLE_SERIAL
+        // A / B press adjusts robot angle offset
+        if (event.type == ButtonEventType::kPress) {
+            auto& bluetooth = getBluetoothTransmitterInstance();
+            if (event.buttons == ButtonMask::kButtonA) {
+                bluetooth.SendAngleOffsetIncrease();
+            } else if (event.buttons == ButtonMask::kButtonB) {
+                bluetooth.SendAngleOffsetDecrease();
+            }
+        }
 #endif
+    }
+}
+
+// Start calibration sweep, or finish it if it is already running
+void toggleCalibrationSweep() {
+    if (calibration_sweep.active) {
+        finishCalibrationSweep();
+    } else {
+        StartCalibrationSweep(&calibration_sweep, &joystick_data);
+    }
 }
 
+#ifdef USE_SERIAL_CONSOLE
+inline InputCapture& getInputCaptureInstance() {
+    static InputCapture input_capture(&Serial);
+    return input_capture;
+}
+
+inline CommandConsole& getCommandConsoleInstance();
+
+// Binary records share Serial with log and console, both are silenced while capture runs
+void setInputCapture(bool enable) {
+    auto& input_capture = getInputCaptureInstance();
+    getCommandConsoleInstance().SetMuted(enable);
+    if (enable) {
+        Log.setLevel(LOG_LEVEL_SILENT);
+        input_capture.Start();
+    } else {
+        input_capture.Stop();
+        changeLogLevel(settings.log_level);
+    }
+}
+
+bool consoleGetParam(void*, ConsoleParam param, int32_t* value) {
+    switch (param) {
+        case ConsoleParam::kPaLevel:  *value = settings.pa_level; return true;
+        case ConsoleParam::kChannel:  *value = settings.radio_channel; return true;
+        case ConsoleParam::kLoopRate: *value = settings.loop_rate_hz; return true;
+        case ConsoleParam::kLogLevel: *value = settings.log_level; return true;
+        case ConsoleParam::kTransport: *value = static_cast<int32_t>(transport_policy); return true;
+        case ConsoleParam::kCapture:  *value = getInputCaptureInstance().IsActive() ? 1 : 0; return true;
+        case ConsoleParam::kNoAck:    *value = getNRF24ControllerInstance().isNoAckMode() ? 1 : 0; return true;
+        case ConsoleParam::kTdma:     *value = getNRF24ControllerInstance().isTdmaEnabled() ? 1 : 0; return true;
+        case ConsoleParam::kControllerId: *value = settings.controller_id; return true;
+        case ConsoleParam::kPidGain1:
+        case ConsoleParam::kPidGain2:
+        case ConsoleParam::kPidGain3:
+        case ConsoleParam::kPidGain4:
+            *value = settings.pid_gains_q8[static_cast<uint8_t>(param) - static_cast<uint8_t>(ConsoleParam::kPidGain1)];
+            return true;
+        default: return false;
+    }
+}
+
+bool consoleSetParam(void*, ConsoleParam param, int32_t value) {
+    auto& nrf24 = getNRF24ControllerInstance();
+    switch (param) {
+        case ConsoleParam::kPaLevel:
+            if (value < RF24_PA_MIN || value > RF24_PA_MAX) return false;
+            settings.pa_level = static_cast<uint8_t>(value);
+            return applyPaLevel();
+        case ConsoleParam::kChannel:
+            if (value < 0 || !nrf24.setChannel(static_cast<uint8_t>(value))) return false;
+            settings.radio_channel = static_cast<uint8_t>(value);
+            return true;
+        case ConsoleParam::kLoopRate:
+            if (value < kMinLoopRateHz || value > kMaxLoopRateHz) return false;
+            settings.loop_rate_hz = static_cast<uint16_t>(value);
+            getPowerManagerInstance().SetTickPeriod(getLoopPeriodUs());
+            return true;
+        case ConsoleParam::kLogLevel:
+            if (value < 0 || value > LOG_LEVEL_VERBOSE) return false;
+            settings.log_level = static_cast<uint8_t>(value);
+            // Level is applied when capture ends
+            if (!getInputCaptureInstance().IsActive()) changeLogLevel(settings.log_level);
+            return true;
+        case ConsoleParam::kTransport:
+            if (value < 0 || value >= static_cast<int32_t>(TransportPolicy::kCount)) return false;
+            transport_policy = static_cast<TransportPolicy>(value);
+            return true;
+        case ConsoleParam::kCapture:
+            if (value != 0 && value != 1) return false;
+            setInputCapture(value == 1);
+            return true;
+        case ConsoleParam::kNoAck:
+            if (value != 0 && value != 1) return false;
+            nrf24.setNoAckMode(value == 1);
+            return true;
+        case ConsoleParam::kTdma:
+            if (value != 0 && value != 1) return false;
+            // Pairing ID is the address byte which differs between controllers of one receiver
+            nrf24.setTdma(value == 1, settings.radio_address[0], static_cast<int8_t>(settings.controller_id));
+            return true;
+        case ConsoleParam::kControllerId:
+            if (value < 0 || value > kMaxControllerId) return false;
+            settings.controller_id = static_cast<uint8_t>(value);
+            if (nrf24.isTdmaEnabled()) {
+                nrf24.setTdma(true, settings.radio_address[0], static_cast<int8_t>(settings.controller_id));
+            }
+            return true;
+        case ConsoleParam::kPidGain1:
+        case ConsoleParam::kPidGain2:
+        case ConsoleParam::kPidGain3:
+        case ConsoleParam::kPidGain4: {
+            // Stored only, BLE build sends gains after "save" and reflash, console and BLE share UART
+            if (value < INT16_MIN || value > INT16_MAX) return false;
+            const uint8_t index = static_cast<uint8_t>(param) - static_cast<uint8_t>(ConsoleParam::kPidGain1);
+            settings.pid_gains_q8[index] = static_cast<int16_t>(value);
+            settings.pid_gain_mask |= static_cast<uint8_t>(1U << index);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void consoleDumpStats(void*, Print* out) {
+    const auto& battery = getBatteryMonitorInstance();
+    const auto& power_manager = getPowerManagerInstance();
+    out->print(RAM_OPT("uptime_ms "));
+    out->println(millis());
+    out->print(RAM_OPT("loop_period_us "));
+    out->println(power_manager.GetTickPeriod());
+    out->print(RAM_OPT("idle_us "));
+    out->println(power_manager.GetIdleTimeUs());
+    out->print(RAM_OPT("battery_mv "));
+    out->println(static_cast<unsigned int>(battery.GetVoltageMv()));
+    out->print(RAM_OPT("battery_state "));
+    out->println(BatteryMonitor::StateToString(battery.GetState()));
+    out->print(RAM_OPT("battery_runtime_min "));
+    out->println(static_cast<unsigned int>(battery.GetRemainingRuntimeMin()));
+    MemoryDiagnostics::PrintReport(out);
+    out->print(RAM_OPT("boot_first_frame_us "));
+    out->println(first_frame_us);
+    out->print(RAM_OPT("log_count "));
+    out->println(log_number);
+    out->print(RAM_OPT("capture_records "));
+    out->println(getInputCaptureInstance().GetRecordCount());
+    out->print(RAM_OPT("capture_dropped "));
+    out->println(static_cast<unsigned int>(getInputCaptureInstance().GetDroppedCount()));
+    const auto& link = getNRF24ControllerInstance().getLinkStats();
+    out->print(RAM_OPT("link_frames_sent "));
+    out->println(link.frames_sent);
+    out->print(RAM_OPT("link_frames_failed "));
+    out->println(link.frames_failed);
+    out->print(RAM_OPT("link_chunks_sent "));
+    out->println(link.chunks_sent);
+    out->print(RAM_OPT("link_chunks_lost "));
+    out->println(link.chunks_failed);
+    out->print(RAM_OPT("link_retransmits "));
+    out->println(link.retransmits);
+    out->print(RAM_OPT("link_rx_frames "));
+    out->println(link.rx_frames);
+    out->print(RAM_OPT("link_rx_dropped "));
+    out->println(link.rx_chunks_dropped);
+    RF24Driver::Telemetry telemetry;
+    if (getNRF24ControllerInstance().getTelemetry(telemetry)) {
+        out->print(RAM_OPT("robot_mode "));
+        out->println(static_cast<unsigned int>(telemetry.mode));
+        out->print(RAM_OPT("robot_battery_mv "));
+        out->println(static_cast<unsigned int>(telemetry.battery_mv));
+        out->print(RAM_OPT("robot_link_quality "));
+        out->println(static_cast<unsigned int>(telemetry.link_quality));
+        out->print(RAM_OPT("robot_pid "));
+        out->print(static_cast<int>(telemetry.pid_setpoint));
+        out->print(' ');
+        out->print(static_cast<int>(telemetry.pid_error));
+        out->print(' ');
+        out->println(static_cast<int>(telemetry.pid_output));
+    } else {
+        out->println(RAM_OPT("robot_telemetry none"));
+    }
+}
+
+void consoleStartCalibration(void*) {
+    toggleCalibrationSweep();
+}
+
+bool consoleSaveSettings(void*) {
+    return getSettingsStoreInstance().Save(settings);
+}
+
+inline CommandConsole& getCommandConsoleInstance() {
+    static CommandConsole command_console(&Serial, ConsoleHandlers{
+        consoleGetParam,
+        consoleSetParam,
+        consoleDumpStats,
+        consoleStartCalibration,
+        consoleSaveSettings,
+        nullptr
+    });
+    return command_console;
+}
+#endif
+
 void setup() {
     // Set up low voltage LED pin
-    pinMode(LOW_VOLTAGE_LED_PIN, OUTPUT);
-    pinMode(SWITCH_TRANSMISSION_MODE_PIN, INPUT_PULLUP);
-    digitalWrite(LOW_VOLTAGE_LED_PIN, LOW); // Turn off LED initially
+    Hal::output<Board::LowVoltageLed>();
+#ifndef ENABLE_IMU
+    Hal::inputPullup<Board::TransmissionModeSwitch>();
+#endif
+    Hal::write<Board::LowVoltageLed>(false); // Turn off LED initially
 
 
 #ifndef ENABLE_BLE_SERIAL
@@ -55,38 +474,112 @@ void setup() {
     // Initialize logging
     initLog();
     #endif
-    // Initialize joystick shield
-    JoystickShieldSetup();
-
-    // Perform initial calibration
-    CalibrateJoystick(&calibration_data);
+    // Load persistent settings, radio needs channel and address
+    auto& settings_store = getSettingsStoreInstance();
+    if (!settings_store.Load(&settings)) {
+        SettingsStore::LoadDefaults(&settings);
+    }
+    changeLogLevel(settings.log_level);
 
+    // Initialize NRF24L01 driver first, first frame can go out as soon as setup ends
+    auto& transport_dispatcher = getTransportDispatcherInstance();
+    auto& nrf24 = getNRF24ControllerInstance();
+    radio_transport = transport_dispatcher.addTransport(&nrf24, 0);
+    if (!nrf24.init()) {
+        LOG_ERROR("Failed to initialize NRF24L01 driver");
+    } else {
+        LOG_INFO("NRF24L01 driver initialized successfully");
+        nrf24.setChannel(settings.radio_channel);
+        applyPaLevel();
+        nrf24.setTxAddress(settings.radio_address);
+    }
 #ifdef ENABLE_BLE_SERIAL
     // changeLogLevel(LOG_LEVEL_SILENT);
+    // BLE module is configured by Update() in loop, this only starts the sequence
     auto& bluetooth = getBluetoothTransmitterInstance();
     bluetooth.Initialize();
+    // Mapping profiles may move the stick off axis_x / axis_y, robot is steered by the stick itself
+    bluetooth.SetStickSource(&joystick_data);
+    ble_transport = transport_dispatcher.addTransport(&bluetooth, kBleMinFrameIntervalUs);
 #endif
-    // Initialize NRF24L01 driver
-    auto& nrf24 = getNRF24ControllerInstance();
-    if (!nrf24.init()) {
-        LOG_ERROR("Failed to initialize NRF24L01 driver");
+
+    // Initialize joystick shield
+    JoystickShieldSetup();
+    getButtonEventsInstance().AddCombo(ButtonMask::kButtonC | ButtonMask::kButtonD);    // profile switch combo
+
+    // Use stored calibration, without it center is calibrated during first loop ticks
+    calibration_data = settings.calibration;
+    if (calibration_data.calibrated) {
+        PrintCalibrationData(&calibration_data);
     } else {
-        LOG_INFO("NRF24L01 driver initialized successfully");
+        StartCenterCalibration(&boot_calibration);
+        is_boot_calibration = true;
     }
-    LOG_INFO("Setup complete");
+#ifdef ENABLE_IMU
+    // Tilt data stays zero if there is no sensor
+    if (getImuInstance().Initialize()) {
+        imu_sample_time_us = micros();
+        getImuInstance().StartRead();
+    }
+#endif
+    // Take first battery sample
+    getBatteryMonitorInstance().Initialize();
+    // Initialize power manager as the last step, first tick is scheduled from now
+    auto& power_manager = getPowerManagerInstance();
+    power_manager.SetTickPeriod(getLoopPeriodUs());
+    power_manager.Initialize();
+    LOG_INFO("Setup complete in %l us", micros());
 }
 
 void loop() {
+    if (is_shutdown) {
+        // Battery is empty, wait for power off
+        getPowerManagerInstance().SleepUntilNextTick();
+        return;
+    }
+#ifdef USE_SERIAL_CONSOLE
+    getCommandConsoleInstance().Poll();
+#endif
+    auto& nrf24 = getNRF24ControllerInstance();
+    if (nrf24.isTdmaEnabled()) {
+        // Tick is aligned just before beacon while locked, otherwise listen longer to acquire it,
+        // but never long enough to stretch a fast tick, beacon is then caught over several ticks
+        const bool is_locked = nrf24.getTdmaClock().isLocked(micros());
+        const uint32_t acquire_window_us =
+            min(kTdmaAcquireWindowUs, getPowerManagerInstance().GetTickPeriod() / kTdmaAcquireTickDivider);
+        nrf24.waitForBeacon(is_locked ? 2 * kTdmaBeaconGuardUs : acquire_window_us);
+    }
     // Read joystick data with calibration
     ReadJoystickData(&joystick_data, &calibration_data);
-    // Read button states
-    ReadButtonStates(&button_states);
+    if (is_boot_calibration && UpdateCenterCalibration(&boot_calibration, &joystick_data, &calibration_data)) {
+        is_boot_calibration = false;
+        settings.calibration = calibration_data;
+        getSettingsStoreInstance().Save(settings);
+    }
+    // Read button states and replace them with debounced ones
+    const uint8_t raw_buttons = ReadButtonMask();
+    const uint32_t input_time_us = micros();
+#ifdef USE_SERIAL_CONSOLE
+    getInputCaptureInstance().Write(input_time_us, joystick_data, raw_buttons);
+#endif
+    auto& button_events = getButtonEventsInstance();
+    button_events.Update(raw_buttons, input_time_us);
+    UnpackButtonStates(button_events.GetState(), &button_states);
+    processButtonEvents();
+
+    // Hold E + F to start full range calibration sweep, hold again to finish it
+    if (CheckCalibrationCombo(&calibration_sweep, &button_states)) {
+        toggleCalibrationSweep();
+    } else if (calibration_sweep.active && !UpdateCalibrationSweep(&calibration_sweep, &joystick_data)) {
+        finishCalibrationSweep();
+    }
 
     // Print joystick and button data
     PrintJoystickData(&joystick_data);
     PrintActiveButtons(&button_states);
 
-    if (digitalRead(SWITCH_TRANSMISSION_MODE_PIN) == LOW) {
+#ifndef ENABLE_IMU
+    if (!Hal::read<Board::TransmissionModeSwitch>()) {
         if (!is_bluetooth_mode) {
             LOG_INFO("Enable Bluetooth mode");
             is_bluetooth_mode = true;
@@ -97,38 +590,61 @@ void loop() {
             is_bluetooth_mode = false;
         }
     }
-    // if (is_bluetooth_mode) {
-#ifdef ENABLE_BLE_SERIAL
-        auto& bluetooth = getBluetoothTransmitterInstance();
-        if (!bluetooth.SendSpeedCommand(joystick_data.x_calibrated, joystick_data.y_calibrated)) {
-            LOG_DEBUG("Failed to send speed command via Bluetooth");
-        }
 #endif
-    // }
     PadData pad_data{
         .joystick = joystick_data,
         .buttons = button_states
     };
-    // Prepare controller data
-    BP32Data::PackedControllerData controller_data{};
-    convertGamepadDataToBP32(controller_data, pad_data);
+    // Prepare controller data with active mapping profile
+    convertGamepadDataToBP32(controller_data, pad_data, input_profile);
+    const bool is_calibration_input = isCalibrationInput();
+    if (is_calibration_input) {
+        setNeutralInput(controller_data);
+    }
+#ifdef ENABLE_IMU
+    updateImu();
+#endif
 
-    // Send controller data via NRF24L01
-    auto& nrf24 = getNRF24ControllerInstance();
-    if (nrf24.checkDriverIsInitialized()) {
-        if (!nrf24.sendGamepadData(controller_data)) {
-            LOG_DEBUG("Failed to send gamepad data");
-        }
-    } else {
-        LOG_WARNING("NRF24L01 driver is not initialized");
+#ifdef ENABLE_BLE_SERIAL
+    // Handle robot responses and BLE link state before sending
+    getBluetoothTransmitterInstance().Update();
+    sendStoredPidGains();
+    // BLE steers from the calibrated stick, neutral frame axes are used during calibration
+    getBluetoothTransmitterInstance().SetStickSource(is_calibration_input ? nullptr : &joystick_data);
+#endif
+    // Send controller data to active transports, each one at its own rate
+    auto& transport_dispatcher = getTransportDispatcherInstance();
+    transport_dispatcher.setActiveMask(getActiveTransports());
+    const uint8_t sent_mask = transport_dispatcher.dispatch(controller_data, micros());
+    if ((sent_mask & radio_transport) == 0 && (transport_dispatcher.getActiveMask() & radio_transport)) {
+        LOG_DEBUG("Failed to send gamepad data");
+    }
+    if (first_frame_us == 0 && sent_mask != 0) {
+        // Time from reset (timer start) to first delivered frame, controllers are power cycled often
+        first_frame_us = micros();
+        LOG_INFO("First frame sent %l us after boot", first_frame_us);
     }
     dump_bluepad_driver_data(controller_data);
+    getNRF24ControllerInstance().reportLinkStats();
 
 
-    if (checkBatteryVoltage()) {
-        digitalWrite(LOW_VOLTAGE_LED_PIN, HIGH); // Turn on LED to indicate low voltage
-        LOG_FATAL("Battery voltage is low!");
+    auto& battery = getBatteryMonitorInstance();
+    if (battery.Update()) {
+        applyBatteryState(battery.GetState());
     }
+    updateStatusLed();
 
-    delayMicroseconds(kMainLoopCycleTimeUs);
+    // Sleep until next tick, radio stays in standby unless the tick is long enough to power it down
+    auto& power_manager = getPowerManagerInstance();
+    if (nrf24.isTdmaEnabled() && nrf24.getTdmaClock().isLocked(micros())) {
+        // Wake up just before next beacon, so the loop runs once per superframe
+        const auto& clock = nrf24.getTdmaClock();
+        power_manager.AlignNextTick(clock.nextSlotStartUs(Tdma::kBeaconSlot, micros()) +
+                                    Tdma::kBeaconLatencyUs - kTdmaBeaconGuardUs);
+    }
+    if (power_manager.GetTickPeriod() >= kRadioPowerDownMinIdleUs ||
+        (transport_dispatcher.getActiveMask() & radio_transport) == 0) {
+        nrf24.powerDown();
+    }
+    power_manager.SleepUntilNextTick();
 }
@@ -0,0 +1,133 @@
+#include "memory_diagnostics.h"
+#include "log.h"
+
+#ifdef __AVR__
+#include <stdlib.h>
+
+// Heap free list entry of avr-libc malloc
+struct FreeListEntry {
+    size_t size;
+    FreeListEntry* next;
+};
+
+namespace
+{
+constexpr uint8_t kStackPaint = 0xC5;
+// Shorter runs of paint value below stack pointer are taken as old stack data
+constexpr uint8_t kMinPaintRun = 8;
+}
+
+extern "C" {
+extern uint8_t __data_start;
+extern uint8_t _end;
+extern uint8_t __stack;
+extern uint8_t __heap_start;
+extern char* __brkval;
+extern FreeListEntry* __flp;
+extern size_t __malloc_margin;
+}
+
+// Runs from .init1 before stack pointer is set and before any constructor, so whole
+// free SRAM is painted. Written in assembly because r1 is not cleared yet.
+extern "C" void PaintStack(void) __attribute__((naked, used, section(".init1")));
+extern "C" void PaintStack(void)
+{
+    __asm volatile (
+        "    ldi r30, lo8(_end)\n"
+        "    ldi r31, hi8(_end)\n"
+        "    ldi r24, %0\n"
+        "    ldi r25, hi8(__stack)\n"
+        "    rjmp 2f\n"
+        "1:  st Z+, r24\n"
+        "2:  cpi r30, lo8(__stack)\n"
+        "    cpc r31, r25\n"
+        "    brlo 1b\n"
+        "    breq 1b\n"
+        :: "M" (kStackPaint));
+}
+
+namespace
+{
+uint8_t* HeapEnd()
+{
+    return __brkval != nullptr ? reinterpret_cast<uint8_t*>(__brkval) : &__heap_start;
+}
+
+uint8_t* StackPointer()
+{
+    return reinterpret_cast<uint8_t*>(SP);
+}
+}
+
+void MemoryDiagnostics::GetReport(Report* report)
+{
+    if (report == nullptr)
+    {
+        return;
+    }
+    uint8_t* const heap_end = HeapEnd();
+    uint8_t* const stack_pointer = StackPointer();
+    report->static_ram = static_cast<uint16_t>(&_end - &__data_start);
+    report->free_now = static_cast<uint16_t>(stack_pointer - heap_end);
+
+    // Stack left its deepest mark below stack pointer, paint survives between it and the highest
+    // byte heap ever used. Scan runs down from stack, because heap end moves back when heap shrinks.
+    const uint8_t* p = stack_pointer;
+    uint16_t run = 0;
+    while (p > heap_end)
+    {
+        --p;
+        if (*p == kStackPaint)
+        {
+            ++run;
+        }
+        else if (run >= kMinPaintRun)
+        {
+            break;
+        }
+        else
+        {
+            run = 0;
+        }
+    }
+    report->stack_unused = run >= kMinPaintRun ? run : 0;
+
+    uint16_t heap_free = 0;
+    uint16_t largest = 0;
+    noInterrupts();
+    for (const FreeListEntry* entry = __flp; entry != nullptr; entry = entry->next)
+    {
+        heap_free += entry->size;
+        largest = max(largest, static_cast<uint16_t>(entry->size));
+    }
+    interrupts();
+    // Heap may also grow towards stack, malloc keeps __malloc_margin bytes for stack
+    const uint16_t growth = report->free_now > __malloc_margin ? report->free_now - __malloc_margin : 0;
+    report->heap_free = heap_free;
+    report->heap_largest_free = max(largest, growth);
+}
+#else
+void MemoryDiagnostics::GetReport(Report* report)
+{
+    if (report != nullptr)
+    {
+        *report = Report{};
+    }
+}
+#endif
+
+void MemoryDiagnostics::PrintReport(Print* out)
+{
+    Report report;
+    GetReport(&report);
+    out->print(RAM_OPT("ram_static "));
+    out->println(static_cast<unsigned int>(report.static_ram));
+    out->print(RAM_OPT("ram_free "));
+    out->println(static_cast<unsigned int>(report.free_now));
+    out->print(RAM_OPT("ram_stack_unused "));
+    out->println(static_cast<unsigned int>(report.stack_unused));
+    out->print(RAM_OPT("ram_heap_free "));
+    out->println(static_cast<unsigned int>(report.heap_free));
+    out->print(RAM_OPT("ram_heap_largest "));
+    out->println(static_cast<unsigned int>(report.heap_largest_free));
+}
@@ -8,7 +8,26 @@ int RF24Driver::NRF24Controller::count = 0;
 
 RF24Driver::NRF24Controller::NRF24Controller(const int ce_pin, const int csn_pin):
         radio_(ce_pin, csn_pin),
-        is_initialized_(false) {
+        is_initialized_(false),
+        is_powered_down_(false),
+        is_listening_(false),
+        is_no_ack_mode_(false),
+        is_tdma_enabled_(false),
+        tdma_pairing_id_(0),
+        tdma_controller_id_(0),
+        tdma_slot_(Tdma::kBeaconSlot + 1),
+        rx_pairing_id_(RF24Driver::address_tx[0]),
+        tdma_clock_(),
+        telemetry_{},
+        telemetry_time_ms_(0),
+        has_telemetry_(false),
+        send_telemetry_(false),
+        link_stats_{},
+        reported_stats_{},
+        report_time_ms_(0),
+        reassembly_{},
+        controllers_{},
+        last_published_slot_(0) {
     count++;
 }
 
@@ -26,10 +45,15 @@ bool RF24Driver::NRF24Controller::init() {
     if (radio_.begin()) {
         LOG_INFO("NRF24Controller initialization begin.");
         // radio_.setPALevel(RF24_PA_HIGH);
-        radio_.setPALevel(RF24_PA_LOW);
+        radio_.setPALevel(kDefaultPALevel);
         // radio_.setDataRate(RF24_250KBPS);
-        radio_.setPayloadSize(sizeof(BP32Data::PackedControllerData));
-        LOG_INFO("Payload set to: %d.", sizeof(BP32Data::PackedControllerData));
+        // Every payload is sent at its own length, ACK payloads with telemetry require it too
+        radio_.enableDynamicPayloads();
+        LOG_INFO("Dynamic payloads enabled, frame size: %d, chunks: %d.",
+                 sizeof(BP32Data::PackedControllerData), kPackageRequiedPerPayload);
+        radio_.enableAckPayload();
+        // Allows NO_ACK writes, receiver needs no configuration for them
+        radio_.enableDynamicAck();
         radio_.openWritingPipe(RF24Driver::address_tx);
         radio_.openReadingPipe(1, RF24Driver::address_rx);
         radio_.stopListening();
@@ -49,23 +73,258 @@ bool RF24Driver::NRF24Controller::checkDriverIsInitialized() const {
 bool RF24Driver::NRF24Controller::sendGamepadData(const BP32Data::PackedControllerData & data) {
     bool status = false;
     if (this->is_initialized_) {
-        radio_.stopListening();
+        if (is_powered_down_) {
+            powerUp();
+        }
+        if (is_listening_) {
+            radio_.stopListening();
+            is_listening_ = false;
+        }
+        if (is_tdma_enabled_ && tdma_clock_.isLocked(micros())) {
+            if (tdma_slot_ == Tdma::kNoSlot) {
+                // Sending outside of the layout would collide with another controller
+                return false;
+            }
+            // Wait for own slot, loop tick is aligned to superframe so the wait is short
+            const uint32_t slot_start_us = tdma_clock_.nextSlotStartUs(tdma_slot_, micros());
+            while (static_cast<int32_t>(micros() - slot_start_us) < 0) {
+            }
+        }
         splitPayloadToPackages(data);
+        status = true;
         for (size_t i = 0; i < kPackageRequiedPerPayload; ++i) {
-            status = radio_.write(&packages_to_send_[i], sizeof(packages_to_send_[i]));
-            if (status) {
-                LOG_INFO("Data sent successfully");
-            } else {
-                LOG_INFO("Data sending failed");
-            }
+            status &= writePackage(packages_to_send_[i]);
         }
-        radio_.startListening();
+        if (is_no_ack_mode_) {
+            Package parity;
+            buildParityPackage(parity);
+            writePackage(parity);
+        }
+        if (status) {
+            ++link_stats_.frames_sent;
+        } else {
+            ++link_stats_.frames_failed;
+        }
+        // Stay in standby-I after transmission, RX mode draws ~13 mA and nothing is read here
     } else {
         LOG_WARNING("NRF24Controller is not initialized");
     }
     return status;
 }
 
+bool RF24Driver::NRF24Controller::writePackage(const Package &package) {
+    if (is_no_ack_mode_) {
+        // Delivery is unknown without ACK, chunk counts as sent once it left the radio
+        radio_.write(&package, kPackageHeaderSize + package.dataBytes, true);
+        ++link_stats_.chunks_sent;
+        return true;
+    }
+    const bool status = radio_.write(&package, kPackageHeaderSize + package.dataBytes);
+    // ARC_CNT holds retransmissions of the last chunk only, accumulate it after each write
+    link_stats_.retransmits += radio_.getARC();
+    if (status) {
+        ++link_stats_.chunks_sent;
+        readAckPayload();
+    } else {
+        ++link_stats_.chunks_failed;
+    }
+    return status;
+}
+
+void RF24Driver::NRF24Controller::powerDown() {
+    if (this->is_initialized_ && !is_powered_down_) {
+        radio_.powerDown();
+        is_powered_down_ = true;
+        is_listening_ = false;
+        LOG_VERBOSE("NRF24Controller powered down");
+    }
+}
+
+void RF24Driver::NRF24Controller::powerUp() {
+    if (this->is_initialized_ && is_powered_down_) {
+        radio_.powerUp();   // blocks until oscillator is stable
+        is_powered_down_ = false;
+        LOG_VERBOSE("NRF24Controller powered up");
+    }
+}
+
+bool RF24Driver::NRF24Controller::isPoweredDown() const {
+    return is_powered_down_;
+}
+
+bool RF24Driver::NRF24Controller::setPALevel(uint8_t pa_level) {
+    if (!this->is_initialized_ || pa_level > RF24_PA_MAX) {
+        LOG_WARNING("Unable to set PA level %d", pa_level);
+        return false;
+    }
+    radio_.setPALevel(pa_level);
+    LOG_INFO("PA level set to: %d", pa_level);
+    return true;
+}
+
+bool RF24Driver::NRF24Controller::setChannel(uint8_t channel) {
+    if (!this->is_initialized_ || channel > kMaxChannel) {
+        LOG_WARNING("Unable to set channel %d", channel);
+        return false;
+    }
+    radio_.setChannel(channel);
+    LOG_INFO("Channel set to: %d", channel);
+    return true;
+}
+
+bool RF24Driver::NRF24Controller::setTxAddress(const uint8_t (&address)[kAddressSize]) {
+    if (!this->is_initialized_) {
+        LOG_WARNING("NRF24Controller is not initialized");
+        return false;
+    }
+    radio_.openWritingPipe(address);
+    LOG_INFO("TX address set to: %c%c%c%c%c", address[0], address[1], address[2], address[3], address[4]);
+    return true;
+}
+
+void RF24Driver::NRF24Controller::setNoAckMode(bool enable) {
+    is_no_ack_mode_ = enable;
+    LOG_INFO("No-ACK mode %s", enable ? "enabled" : "disabled");
+}
+
+bool RF24Driver::NRF24Controller::isNoAckMode() const {
+    return is_no_ack_mode_;
+}
+
+bool RF24Driver::NRF24Controller::sendBeacon(uint8_t slot_count, uint16_t slot_us) {
+    if (!this->is_initialized_) {
+        LOG_WARNING("NRF24Controller is not initialized");
+        return false;
+    }
+    if (is_powered_down_) {
+        powerUp();
+    }
+    if (is_listening_) {
+        radio_.stopListening();
+    }
+    radio_.openWritingPipe(RF24Driver::address_rx);
+    const uint8_t ids_per_pipe = slot_count > 0 ? static_cast<uint8_t>((slot_count - 1) / BP32Data::kMaxControllers) : 0;
+    const Tdma::Beacon beacon = {Tdma::kBeaconType, slot_count, slot_us, static_cast<uint32_t>(micros()),
+                                 rx_pairing_id_, ids_per_pipe, {0, 0}};
+    // Broadcast without ACK, every controller listens on the same address
+    const bool status = radio_.write(&beacon, sizeof(beacon), true);
+    radio_.startListening();
+    is_listening_ = true;
+    return status;
+}
+
+bool RF24Driver::NRF24Controller::waitForBeacon(uint32_t timeout_us) {
+    if (!this->is_initialized_) {
+        return false;
+    }
+    if (is_powered_down_) {
+        powerUp();
+    }
+    if (!is_listening_) {
+        radio_.startListening();
+        is_listening_ = true;
+    }
+    const uint32_t start_us = micros();
+    uint8_t pipe;
+    while (micros() - start_us < timeout_us) {
+        if (!radio_.available(&pipe)) {
+            continue;
+        }
+        // Time stamp is taken as soon as payload is seen, polling keeps the jitter to a few us
+        const uint32_t received_us = micros();
+        const uint8_t bytes = radio_.getDynamicPayloadSize();
+        Tdma::Beacon beacon;
+        radio_.read(&beacon, min(bytes, static_cast<uint8_t>(sizeof(beacon))));
+        if (bytes != sizeof(beacon) || !tdma_clock_.onBeacon(beacon, received_us)) {
+            continue;
+        }
+        const uint8_t slot = Tdma::assignSlot(tdma_pairing_id_, tdma_controller_id_, beacon);
+        if (slot == Tdma::kNoSlot && tdma_slot_ != Tdma::kNoSlot) {
+            LOG_WARNING("No TDMA slot for pairing ID %d, controller ID %d", tdma_pairing_id_, tdma_controller_id_);
+        }
+        tdma_slot_ = slot;
+        return true;
+    }
+    return false;
+}
+
+void RF24Driver::NRF24Controller::setTdma(bool enable, uint8_t pairing_id, int8_t controller_id) {
+    is_tdma_enabled_ = enable;
+    tdma_pairing_id_ = pairing_id;
+    tdma_controller_id_ = controller_id;
+    LOG_INFO("TDMA %s, pairing ID: %d, controller ID: %d", enable ? "enabled" : "disabled", pairing_id, controller_id);
+}
+
+bool RF24Driver::NRF24Controller::isTdmaEnabled() const {
+    return is_tdma_enabled_;
+}
+
+const Tdma::Clock& RF24Driver::NRF24Controller::getTdmaClock() const {
+    return tdma_clock_;
+}
+
+uint8_t RF24Driver::NRF24Controller::getTdmaSlot() const {
+    return tdma_slot_;
+}
+
+bool RF24Driver::NRF24Controller::getTelemetry(Telemetry &telemetry) const {
+    if (!has_telemetry_ || millis() - telemetry_time_ms_ > kTelemetryTimeoutMs) {
+        return false;
+    }
+    telemetry = telemetry_;
+    return true;
+}
+
+const RF24Driver::LinkStats& RF24Driver::NRF24Controller::getLinkStats() const {
+    return link_stats_;
+}
+
+bool RF24Driver::NRF24Controller::reportLinkStats() {
+    const uint32_t now_ms = millis();
+    if (now_ms - report_time_ms_ < kLinkStatsReportPeriodMs) {
+        return false;
+    }
+    // Values since last report, unsigned difference stays valid across counter rollover
+    const uint32_t chunks_sent = link_stats_.chunks_sent - reported_stats_.chunks_sent;
+    const uint32_t chunks_failed = link_stats_.chunks_failed - reported_stats_.chunks_failed;
+    const uint32_t chunks = chunks_sent + chunks_failed;
+    LOG_INFO("Link: frames %l ok %l failed, chunks %l lost of %l, retransmits %l, rx frames %l, rx dropped %l, failsafe %l, recovered %l",
+             link_stats_.frames_sent - reported_stats_.frames_sent,
+             link_stats_.frames_failed - reported_stats_.frames_failed,
+             chunks_failed,
+             chunks,
+             link_stats_.retransmits - reported_stats_.retransmits,
+             link_stats_.rx_frames - reported_stats_.rx_frames,
+             link_stats_.rx_chunks_dropped - reported_stats_.rx_chunks_dropped,
+             link_stats_.rx_failsafe_events - reported_stats_.rx_failsafe_events,
+             link_stats_.rx_chunks_recovered - reported_stats_.rx_chunks_recovered);
+    reported_stats_ = link_stats_;
+    report_time_ms_ = now_ms;
+    return true;
+}
+
+void RF24Driver::NRF24Controller::setTelemetry(const Telemetry &telemetry) {
+    telemetry_ = telemetry;
+    telemetry_.type = kTelemetryType;
+    send_telemetry_ = true;
+}
+
+void RF24Driver::NRF24Controller::readAckPayload() {
+    // ACK payload arrives together with ACK, so it costs no extra air time
+    while (radio_.available()) {
+        const uint8_t bytes = radio_.getDynamicPayloadSize();
+        Telemetry telemetry;
+        radio_.read(&telemetry, min(bytes, static_cast<uint8_t>(sizeof(telemetry))));
+        if (bytes != sizeof(Telemetry) || telemetry.type != kTelemetryType) {
+            LOG_DEBUG("Unexpected ACK payload, size: %d", bytes);
+            continue;
+        }
+        telemetry_ = telemetry;
+        telemetry_time_ms_ = millis();
+        has_telemetry_ = true;
+    }
+}
+
 void dumpPacketToLog(uint8_t data_to_dump[28]) {
     char str[128];
     char *buf_ptr = str;
@@ -75,35 +334,95 @@ void dumpPacketToLog(uint8_t data_to_dump[28]) {
     LOG_VERBOSE("Data: %s", str);
 }
 
-bool RF24Driver::NRF24Controller::receiveGamepadData(BP32Data::PackedControllerData & data) {
-    bool status = false;
-    if (this->is_initialized_) {
-        uint8_t pipe;
-        if (radio_.available(&pipe)) {              // is there a payload? get the pipe number that recieved it
-            const uint8_t bytes = radio_.getPayloadSize();  // get the size of the payload
-            PackageContainer received_packet;
-            received_packet.package_size = bytes;
-            radio_.read(&received_packet.package, bytes);             // fetch payload from FIFO
-            LOG_VERBOSE("Received %d bytes on pipe %d", bytes, pipe);
-            status = true;
-
-            // If it's the first chunk of a new packet, update metadata
-            if (received_packet.package.chunkIndex == 0) {
-                received_chunk = 0;
-                received_packet_id = received_packet.package.packetID;
-                received_total_chunks = received_packet.package.totalChunks;
-                LOG_DEBUG("Received packet ID: %d, total chunks: %d", received_packet_id, received_total_chunks);
-            }
-            dumpPacketToLog(received_packet.package.data);
-            // merge received packages to payload
-            convertPackageToPayload(data, received_packet);
-        } else {
-            LOG_VERBOSE("No data available");
-        }
-    } else {
+uint8_t RF24Driver::NRF24Controller::pollControllers() {
+    uint8_t published = 0;
+    if (!this->is_initialized_) {
         LOG_WARNING("NRF24Controller is not initialized");
+        return published;
     }
-    return status;
+    if (is_powered_down_) {
+        powerUp();
+    }
+    if (!is_listening_) {
+        radio_.startListening();
+        is_listening_ = true;
+    }
+    // Drain whole FIFO, otherwise one busy controller delays chunks of the others
+    uint8_t pipe;
+    for (uint8_t i = 0; i < kMaxChunksPerPoll && radio_.available(&pipe); ++i) {
+        const uint8_t bytes = radio_.getDynamicPayloadSize();  // get the size of the payload
+        PackageContainer received_packet;
+        received_packet.package_size = bytes;
+        radio_.read(&received_packet.package, min(bytes, static_cast<uint8_t>(sizeof(Package))));   // fetch payload from FIFO
+        if (send_telemetry_) {
+            // ACK payload is consumed by each ACK, queue it again for next chunk
+            radio_.writeAckPayload(pipe, &telemetry_, sizeof(telemetry_));
+        }
+        LOG_VERBOSE("Received %d bytes on pipe %d", bytes, pipe);
+        if (pipe < kFirstRxPipe || pipe >= kFirstRxPipe + BP32Data::kMaxControllers) {
+            LOG_WARNING("Chunk on unexpected pipe %d. Discarding packet", pipe);
+            ++link_stats_.rx_chunks_dropped;
+            continue;
+        }
+        dumpPacketToLog(received_packet.package.data);
+        const uint8_t slot = pipe - kFirstRxPipe;
+        const uint32_t now_ms = millis();
+        if (convertPackageToPayload(slot, received_packet, now_ms) &&
+            controllers_.update(slot, reassembly_[slot].data, now_ms)) {
+            last_published_slot_ = slot;
+            ++published;
+        }
+    }
+    // Neutral data replaces output of controllers which stopped sending
+    const uint8_t failsafe_mask = controllers_.updateFailsafe(millis());
+    for (uint8_t slot = 0; slot < BP32Data::kMaxControllers; ++slot) {
+        if (failsafe_mask & (1U << slot)) {
+            ++link_stats_.rx_failsafe_events;
+            last_published_slot_ = slot;
+            ++published;
+        }
+    }
+    return published;
+}
+
+bool RF24Driver::NRF24Controller::receiveGamepadData(BP32Data::PackedControllerData & data) {
+    if (pollControllers() == 0) {
+        LOG_VERBOSE("No data available");
+        return false;
+    }
+    const auto* controller = controllers_.get(last_published_slot_);
+    if (controller == nullptr) {
+        return false;
+    }
+    data = controller->controllerData();
+    return true;
+}
+
+const BP32Data::ControllerTable& RF24Driver::NRF24Controller::getControllers() const {
+    return controllers_;
+}
+
+BP32Data::ControllerTable& RF24Driver::NRF24Controller::getControllers() {
+    return controllers_;
+}
+
+void RF24Driver::NRF24Controller::setFailsafeConfig(const BP32Data::FailsafeConfig &config) {
+    controllers_.setFailsafeConfig(config);
+    LOG_INFO("Failsafe timeout: %l ms, recovery frames: %d", config.timeout_ms, config.recovery_frames);
+}
+
+bool RF24Driver::NRF24Controller::setRxAddress(uint8_t pipe, const uint8_t (&address)[kAddressSize]) {
+    if (!this->is_initialized_ || pipe < kFirstRxPipe || pipe >= kFirstRxPipe + BP32Data::kMaxControllers) {
+        LOG_WARNING("Unable to set RX address of pipe %d", pipe);
+        return false;
+    }
+    radio_.openReadingPipe(pipe, address);
+    resetReceivedPackages(pipe - kFirstRxPipe);
+    if (pipe == kFirstRxPipe) {
+        rx_pairing_id_ = address[0];
+    }
+    LOG_INFO("RX address of pipe %d set to: %c%c%c%c%c", pipe, address[0], address[1], address[2], address[3], address[4]);
+    return true;
 }
 
 void RF24Driver::NRF24Controller::splitPayloadToPackages(const BP32Data::PackedControllerData & data) {
@@ -125,53 +444,124 @@ void RF24Driver::NRF24Controller::splitPayloadToPackages(const BP32Data::PackedC
     }
 }
 
-void RF24Driver::NRF24Controller::convertPackageToPayload(BP32Data::PackedControllerData &data, const PackageContainer &packet_container) {
-    // Check if the packet ID matches the expected ID
-    if (packet_container.package.packetID != received_packet_id) {
-        LOG_WARNING("Unexpected Packet ID %d. Last received packet %d. Discarding packet",
-               static_cast<int>(packet_container.package.packetID),
-               static_cast<int>(received_packet_id));
-        return;
+void RF24Driver::NRF24Controller::buildParityPackage(Package &parity) const {
+    parity.packetID = packages_to_send_[0].packetID;
+    parity.chunkIndex = kParityChunkIndex;
+    parity.totalChunks = kPackageRequiedPerPayload;
+    parity.dataBytes = kPackageDataSize;
+    memset(parity.data, 0, sizeof(parity.data));
+    for (const auto &package : packages_to_send_) {
+        // Bytes past dataBytes count as zero, so the short last chunk needs no padding
+        for (uint8_t i = 0; i < package.dataBytes; ++i) {
+            parity.data[i] ^= package.data[i];
+        }
+    }
+}
+
+void RF24Driver::NRF24Controller::recoverMissingChunk(Reassembly &reassembly, uint8_t missing_chunk) const {
+    auto* dataPtr = reinterpret_cast<uint8_t*>(&reassembly.data);
+    const size_t missing_offset = missing_chunk * kPackageDataSize;
+    const size_t missing_size = min(kPackageDataSize, sizeof(BP32Data::PackedControllerData) - missing_offset);
+    for (size_t i = 0; i < missing_size; ++i) {
+        uint8_t value = reassembly.parity[i];
+        for (uint8_t chunk = 0; chunk < kPackageRequiedPerPayload; ++chunk) {
+            const size_t offset = chunk * kPackageDataSize + i;
+            if (chunk != missing_chunk && offset < sizeof(BP32Data::PackedControllerData)) {
+                value ^= dataPtr[offset];
+            }
+        }
+        dataPtr[missing_offset + i] = value;
+    }
+}
+
+bool RF24Driver::NRF24Controller::convertPackageToPayload(uint8_t slot, const PackageContainer &packet_container,
+                                                          uint32_t now_ms) {
+    const Package &package = packet_container.package;
+    Reassembly &reassembly = reassembly_[slot];
+    const bool is_parity = package.chunkIndex == kParityChunkIndex;
+
+    // Header fields are not valid in payloads shorter than header
+    if (packet_container.package_size < kPackageHeaderSize) {
+        LOG_WARNING("Payload of %d bytes too short. Discarding packet", static_cast<int>(packet_container.package_size));
+        ++link_stats_.rx_chunks_dropped;
+        return false;
     }
 
-    // Check if the chunk index is within bounds
-    if (packet_container.package.chunkIndex >= received_total_chunks) {
-        LOG_WARNING("Invalid Chunk Index %d. Total expected chunks: %d. Discarding packet",
-               static_cast<int>(packet_container.package.chunkIndex),
-               static_cast<int>(received_total_chunks));
-        return;
+    // Check if the chunk belongs to the same frame layout as ours
+    if (package.totalChunks != kPackageRequiedPerPayload || package.chunkIndex > kParityChunkIndex) {
+        LOG_WARNING("Invalid Chunk Index %d of %d. Discarding packet",
+               static_cast<int>(package.chunkIndex),
+               static_cast<int>(package.totalChunks));
+        ++link_stats_.rx_chunks_dropped;
+        return false;
     }
 
-    // Check if the chunk data bytes is within bounds
-    if (packet_container.package.dataBytes > sizeof(PackageContainer::package.data)) {
-        LOG_WARNING("Invalid Data Bytes %d. Package data size %d. Discarding packet",
-               static_cast<int>(packet_container.package.dataBytes),
-               static_cast<int>(sizeof(PackageContainer::package.data)));
-        return;
+    // Check if the chunk data fits into the frame and matches received payload length
+    const size_t start_byte = package.chunkIndex * sizeof(Package::data);
+    if (package.dataBytes > sizeof(Package::data) ||
+        packet_container.package_size != kPackageHeaderSize + package.dataBytes ||
+        (!is_parity && start_byte + package.dataBytes > sizeof(BP32Data::PackedControllerData))) {
+        LOG_WARNING("Invalid Data Bytes %d. Payload size %d. Discarding packet",
+               static_cast<int>(package.dataBytes),
+               static_cast<int>(packet_container.package_size));
+        ++link_stats_.rx_chunks_dropped;
+        return false;
+    }
+
+    // Chunk of a newer frame abandons the incomplete one, stale state is dropped after packet ID wrap
+    const bool is_stale = now_ms - reassembly.chunk_time_ms > kReassemblyTimeoutMs;
+    reassembly.chunk_time_ms = now_ms;
+    if (!reassembly.active || is_stale || package.packetID != reassembly.packet_id) {
+        if (reassembly.active && !reassembly.complete) {
+            LOG_DEBUG("Packet ID %d incomplete, new packet %d",
+                   static_cast<int>(reassembly.packet_id),
+                   static_cast<int>(package.packetID));
+        }
+        reassembly.packet_id = package.packetID;
+        reassembly.chunk_mask = 0;
+        reassembly.active = true;
+        reassembly.complete = false;
+    } else if (reassembly.complete) {
+        // Parity of a frame which arrived complete is not needed
+        return false;
     }
 
     // Copy the received data chunk into the appropriate position in the data buffer
-    const uint16_t startByte = packet_container.package.chunkIndex * sizeof(Package::data);
-    auto* dataPtr = reinterpret_cast<char*>(&received_data_);
-    memcpy(&dataPtr[startByte], packet_container.package.data, packet_container.package.dataBytes);
-
-    // Increment the received chunks counter
-    ++received_chunk;
-
-    // Check if all chunks have been received
-    if (received_chunk == received_total_chunks) {
-        // All data received, process or use the complete data
-        LOG_DEBUG("All data received: %d", received_chunk);
-        memcpy(&data, &received_data_, sizeof(BP32Data::PackedControllerData));
-        // Reset receiver for next packet reception
-        resetReceivedPackages();
+    if (is_parity) {
+        memcpy(reassembly.parity, package.data, sizeof(reassembly.parity));
     } else {
-        LOG_DEBUG("Data received: %d, total %d ", received_chunk, received_total_chunks);
-  }
+        auto* dataPtr = reinterpret_cast<uint8_t*>(&reassembly.data);
+        memcpy(&dataPtr[start_byte], package.data, package.dataBytes);
+    }
+    reassembly.chunk_mask |= static_cast<uint8_t>(1U << package.chunkIndex);
+
+    // Check if all chunks have been received, or all but one together with parity
+    constexpr uint8_t kAllChunks = static_cast<uint8_t>((1U << kPackageRequiedPerPayload) - 1);
+    constexpr uint8_t kParityBit = static_cast<uint8_t>(1U << kParityChunkIndex);
+    const uint8_t missing = kAllChunks & ~reassembly.chunk_mask;
+    if (missing != 0) {
+        const bool is_single_missing = (missing & (missing - 1)) == 0;
+        if (!(reassembly.chunk_mask & kParityBit) || !is_single_missing) {
+            LOG_DEBUG("Data received: 0x%x, slot %d", reassembly.chunk_mask, slot);
+            return false;
+        }
+        uint8_t missing_chunk = 0;
+        while (!(missing & (1U << missing_chunk))) {
+            ++missing_chunk;
+        }
+        recoverMissingChunk(reassembly, missing_chunk);
+        ++link_stats_.rx_chunks_recovered;
+        LOG_DEBUG("Chunk %d recovered from parity, slot %d", missing_chunk, slot);
+    }
+    LOG_DEBUG("All data received, slot %d", slot);
+    ++link_stats_.rx_frames;
+    // Late chunks of this packet are ignored until the next one starts
+    reassembly.complete = true;
+    return true;
 }
 
-void RF24Driver::NRF24Controller::resetReceivedPackages() {
-    received_chunk = 0;
-    received_packet_id = 0;
-    received_total_chunks = 0;
+void RF24Driver::NRF24Controller::resetReceivedPackages(uint8_t slot) {
+    reassembly_[slot].chunk_mask = 0;
+    reassembly_[slot].active = false;
+    reassembly_[slot].complete = false;
 }
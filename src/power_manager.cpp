@@ -0,0 +1,144 @@
+#include "power_manager.h"
+#include "pin_config.h"
+#include "log.h"
+
+#if defined(__AVR__) && defined(ENABLE_LOW_POWER_IDLE)
+#include <avr/sleep.h>
+#include <avr/power.h>
+#include <avr/interrupt.h>
+#define POWER_MANAGER_USE_SLEEP
+#endif
+
+namespace
+{
+// Pins which wake the MCU on change
+constexpr int kWakeUpPins[] = {
+    A_PIN, B_PIN, C_PIN, D_PIN, E_PIN, F_PIN, JOYSTICK_BUTTON_PIN
+};
+
+// Set from pin-change ISR, cleared by the main loop
+volatile bool button_wake_up = false;
+}
+
+#ifdef POWER_MANAGER_USE_SLEEP
+// Buttons are spread over PORTB (pin 8) and PORTD (pins 2-7)
+ISR(PCINT0_vect) { button_wake_up = true; }
+ISR(PCINT2_vect) { button_wake_up = true; }
+#endif
+
+PowerManager::PowerManager(uint32_t tick_period_us)
+    : tick_period_us_(tick_period_us),
+      next_tick_us_(0),
+      idle_time_us_(0),
+      is_initialized_(false)
+{
+}
+
+void PowerManager::Initialize()
+{
+#ifdef POWER_MANAGER_USE_SLEEP
+    noInterrupts();
+    for (const auto pin : kWakeUpPins)
+    {
+        *digitalPinToPCMSK(pin) |= bit(digitalPinToPCMSKbit(pin));
+        PCIFR |= bit(digitalPinToPCICRbit(pin));    // clear pending request
+        *digitalPinToPCICR(pin) |= bit(digitalPinToPCICRbit(pin));
+    }
+    interrupts();
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    LOG_INFO("Power manager initialized, idle sleep enabled");
+#else
+    (void)kWakeUpPins;
+    LOG_INFO("Power manager initialized, idle sleep disabled");
+#endif
+    next_tick_us_ = micros() + tick_period_us_;
+    is_initialized_ = true;
+}
+
+bool PowerManager::SleepUntilNextTick()
+{
+    if (!is_initialized_)
+    {
+        Initialize();
+    }
+
+    const uint32_t start_us = micros();
+    bool woken_by_button = false;
+    // Signed difference keeps the comparison valid across micros() rollover
+    while (static_cast<int32_t>(micros() - next_tick_us_) < 0)
+    {
+        if (button_wake_up)
+        {
+            woken_by_button = true;
+            break;
+        }
+#ifdef POWER_MANAGER_USE_SLEEP
+        // Timer0 overflow wakes the core every ~1 ms, so the tick is never missed
+        EnterIdleSleep();
+#endif
+    }
+    button_wake_up = false;
+
+    const uint32_t now_us = micros();
+    idle_time_us_ += now_us - start_us;
+    if (woken_by_button || static_cast<int32_t>(now_us - next_tick_us_) >= static_cast<int32_t>(tick_period_us_))
+    {
+        // Restart schedule from now instead of bursting to catch up missed ticks
+        next_tick_us_ = now_us + tick_period_us_;
+    }
+    else
+    {
+        next_tick_us_ += tick_period_us_;
+    }
+    return woken_by_button;
+}
+
+void PowerManager::SetTickPeriod(uint32_t tick_period_us)
+{
+    if (tick_period_us == 0)
+    {
+        LOG_WARNING("Invalid tick period: %l us", tick_period_us);
+        return;
+    }
+    tick_period_us_ = tick_period_us;
+}
+
+void PowerManager::AlignNextTick(uint32_t tick_us)
+{
+    const int32_t ahead_us = static_cast<int32_t>(tick_us - micros());
+    if (ahead_us <= 0 || static_cast<uint32_t>(ahead_us) > 2 * tick_period_us_)
+    {
+        return;
+    }
+    next_tick_us_ = tick_us;
+}
+
+void PowerManager::EnterIdleSleep()
+{
+#ifdef POWER_MANAGER_USE_SLEEP
+    // Gate clocks of peripherals which are not used while waiting
+    const uint8_t adcsra = ADCSRA;
+    ADCSRA &= ~bit(ADEN);
+    power_adc_disable();
+#ifndef ENABLE_IMU
+    // IMU reads run on TWI in background while the core sleeps
+    power_twi_disable();
+#endif
+
+    noInterrupts();
+    if (!button_wake_up)
+    {
+        sleep_enable();
+        interrupts();   // instruction after sei is always executed, so no wake-up is lost
+        sleep_cpu();
+        sleep_disable();
+    }
+    interrupts();
+
+#ifndef ENABLE_IMU
+    power_twi_enable();
+#endif
+    power_adc_enable();
+    ADCSRA = adcsra;
+#endif
+}
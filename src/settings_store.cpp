@@ -0,0 +1,123 @@
+#include <EEPROM.h>
+#include "settings_store.h"
+#include "nrf24_driver.h"
+#include "config.h"
+#include "log.h"
+
+SettingsStore::SettingsStore()
+    : next_slot_(0),
+      next_sequence_(0)
+{
+#if defined(ARDUINO_ARCH_RP2040)
+    // EEPROM is emulated in flash, its RAM copy has to be set up before first access
+    EEPROM.begin(kEepromStart + kEepromSize);
+#endif
+}
+
+bool SettingsStore::Load(Settings* settings)
+{
+    if (settings == nullptr) return false;
+
+    bool found = false;
+    Record newest;
+    for (uint8_t slot = 0; slot < kSlotCount; ++slot)
+    {
+        Record record;
+        if (!ReadSlot(slot, &record))
+        {
+            continue;
+        }
+        // Signed difference keeps ordering valid across sequence wrap
+        if (!found || static_cast<int16_t>(record.sequence - newest.sequence) > 0)
+        {
+            newest = record;
+            next_slot_ = (slot + 1) % kSlotCount;
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        LOG_WARNING("No valid settings in EEPROM");
+        return false;
+    }
+    next_sequence_ = newest.sequence + 1;
+    *settings = newest.settings;
+    LOG_INFO("Settings loaded, sequence: %d", newest.sequence);
+    return true;
+}
+
+bool SettingsStore::Save(const Settings& settings)
+{
+    Record record;
+    record.magic = kMagic;
+    record.version = kVersion;
+    record.sequence = next_sequence_;
+    record.settings = settings;
+    record.crc = CalculateCrc(record);
+
+    // EEPROM.put only writes bytes which differ
+    EEPROM.put(SlotAddress(next_slot_), record);
+#if defined(ARDUINO_ARCH_RP2040)
+    if (!EEPROM.commit())
+    {
+        LOG_ERROR("Settings flash commit failed");
+        return false;
+    }
+#endif
+
+    Record verify;
+    if (!ReadSlot(next_slot_, &verify) || verify.sequence != record.sequence)
+    {
+        LOG_ERROR("Settings verification failed in slot %d", next_slot_);
+        return false;
+    }
+    LOG_INFO("Settings saved to slot %d, sequence: %d", next_slot_, next_sequence_);
+    next_slot_ = (next_slot_ + 1) % kSlotCount;
+    ++next_sequence_;
+    return true;
+}
+
+void SettingsStore::LoadDefaults(Settings* settings)
+{
+    if (settings == nullptr) return;
+
+    memset(settings, 0, sizeof(Settings));
+    settings->calibration.calibrated = false;
+    memcpy(settings->radio_address, RF24Driver::address_tx, sizeof(settings->radio_address));
+    settings->radio_channel = RF24Driver::kDefaultChannel;
+    settings->pa_level = RF24Driver::kDefaultPALevel;
+    settings->log_level = LOG_LEVEL_TRACE;
+    settings->loop_rate_hz = static_cast<uint16_t>(1000000UL / kMainLoopCycleTimeUs);
+    // Robot keeps its own gains until they are configured here
+    settings->pid_gain_mask = 0;
+    settings->controller_id = 0;
+}
+
+bool SettingsStore::ReadSlot(uint8_t slot, Record* record)
+{
+    EEPROM.get(SlotAddress(slot), *record);
+    return record->magic == kMagic &&
+           record->version == kVersion &&
+           record->crc == CalculateCrc(*record);
+}
+
+uint16_t SettingsStore::CalculateCrc(const Record& record)
+{
+    const auto* data = reinterpret_cast<const uint8_t*>(&record);
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < offsetof(Record, crc); ++i)
+    {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+uint16_t SettingsStore::SlotAddress(uint8_t slot)
+{
+    return kEepromStart + slot * sizeof(Record);
+}
@@ -0,0 +1,87 @@
+#include "tdma_schedule.h"
+
+namespace
+{
+constexpr int32_t kMaxDriftPpm = 2000;      // crystal and resonator clocks stay well below
+constexpr uint8_t kDriftFilterShift = 2;    // weight of new drift measurement 1/4
+constexpr uint8_t kIntervalShift = 6;       // interval is scaled down to keep ppm math in int32
+constexpr int32_t kPpmDivider = 1000000 >> kIntervalShift;
+}
+
+uint8_t Tdma::assignSlot(uint8_t pairing_id, int8_t controller_id, const Beacon &beacon) {
+    if (beacon.slot_count < kMinSlotCount || controller_id < 0 || controller_id >= beacon.ids_per_pipe) {
+        return kNoSlot;
+    }
+    // Pairing IDs below base wrap to large pipe indexes and are rejected with them
+    const uint8_t pipe_index = static_cast<uint8_t>(pairing_id - beacon.base_pairing_id);
+    const uint16_t index = static_cast<uint16_t>(pipe_index) * beacon.ids_per_pipe + static_cast<uint8_t>(controller_id);
+    if (index >= beacon.slot_count - 1U) {
+        return kNoSlot;
+    }
+    return static_cast<uint8_t>(kBeaconSlot + 1 + index);
+}
+
+Tdma::Clock::Clock():
+        beacon_network_us_(0),
+        beacon_local_us_(0),
+        drift_ppm_(0),
+        slot_us_(0),
+        slot_count_(0),
+        has_beacon_(false) {
+}
+
+bool Tdma::Clock::onBeacon(const Beacon &beacon, uint32_t local_us) {
+    if (beacon.type != kBeaconType || beacon.slot_count < kMinSlotCount || beacon.slot_us == 0) {
+        return false;
+    }
+    const uint32_t network_us = beacon.time_us + kBeaconLatencyUs;
+    if (isLocked(local_us)) {
+        // Drift from intervals between beacons, offset itself is replaced below
+        const uint32_t local_interval = local_us - beacon_local_us_;
+        const int32_t error_us = static_cast<int32_t>((network_us - beacon_network_us_) - local_interval);
+        const int32_t scaled_interval = static_cast<int32_t>(local_interval >> kIntervalShift);
+        if (scaled_interval > 0) {
+            // Implausible values come from late beacon detection, they would bias the estimate
+            const int32_t measured_ppm = error_us * kPpmDivider / scaled_interval;
+            if (measured_ppm <= kMaxDriftPpm && measured_ppm >= -kMaxDriftPpm) {
+                drift_ppm_ += (measured_ppm - drift_ppm_) / (1 << kDriftFilterShift);
+            }
+        }
+    }
+    beacon_network_us_ = network_us;
+    beacon_local_us_ = local_us;
+    slot_us_ = beacon.slot_us;
+    slot_count_ = beacon.slot_count;
+    has_beacon_ = true;
+    return true;
+}
+
+bool Tdma::Clock::isLocked(uint32_t local_us) const {
+    return has_beacon_ && local_us - beacon_local_us_ < kLockTimeoutUs;
+}
+
+int32_t Tdma::Clock::correctionUs(uint32_t local_interval_us) const {
+    return static_cast<int32_t>(local_interval_us >> kIntervalShift) * drift_ppm_ / kPpmDivider;
+}
+
+uint32_t Tdma::Clock::toNetworkUs(uint32_t local_us) const {
+    const uint32_t interval = local_us - beacon_local_us_;
+    return beacon_network_us_ + interval + correctionUs(interval);
+}
+
+uint32_t Tdma::Clock::nextSlotStartUs(uint8_t slot, uint32_t local_us) const {
+    const uint32_t superframe_us = superframeUs();
+    if (!has_beacon_ || superframe_us == 0) {
+        return local_us;
+    }
+    // Superframe starts when receiver writes the beacon, which is kBeaconLatencyUs before it was received
+    const uint32_t since_origin = toNetworkUs(local_us) - (beacon_network_us_ - kBeaconLatencyUs);
+    const uint32_t slot_offset = static_cast<uint32_t>(slot % slot_count_) * slot_us_;
+    uint32_t start = since_origin - since_origin % superframe_us + slot_offset;
+    if (start < since_origin) {
+        start += superframe_us;
+    }
+    // Back to local time base, drift correction is small so it is applied with inverted sign
+    const uint32_t since_beacon = start - kBeaconLatencyUs;
+    return beacon_local_us_ + since_beacon - correctionUs(since_beacon);
+}
@@ -0,0 +1,52 @@
+#include "transport_dispatcher.h"
+#include "log.h"
+
+TransportDispatcher::TransportDispatcher():
+        entries_{},
+        count_(0),
+        active_mask_(0) {
+}
+
+uint8_t TransportDispatcher::addTransport(Transport* transport, uint32_t min_interval_us) {
+    if (transport == nullptr || count_ >= kMaxTransports) {
+        LOG_WARNING("Unable to register transport");
+        return 0;
+    }
+    entries_[count_] = Entry{transport, min_interval_us, 0, false};
+    LOG_INFO("Transport %s registered, min interval: %l us", transport->name(), min_interval_us);
+    return static_cast<uint8_t>(1U << count_++);
+}
+
+void TransportDispatcher::setActiveMask(uint8_t mask) {
+    if (mask == active_mask_) {
+        return;
+    }
+    for (uint8_t i = 0; i < count_; ++i) {
+        const uint8_t bit = static_cast<uint8_t>(1U << i);
+        if ((mask ^ active_mask_) & bit) {
+            LOG_INFO("Transport %s %s", entries_[i].transport->name(), (mask & bit) ? "enabled" : "disabled");
+        }
+    }
+    active_mask_ = mask;
+}
+
+uint8_t TransportDispatcher::dispatch(const BP32Data::PackedControllerData &data, uint32_t now_us) {
+    uint8_t sent_mask = 0;
+    for (uint8_t i = 0; i < count_; ++i) {
+        const uint8_t bit = static_cast<uint8_t>(1U << i);
+        Entry &entry = entries_[i];
+        if (!(active_mask_ & bit) || !entry.transport->isReady()) {
+            continue;
+        }
+        if (entry.has_sent && now_us - entry.last_send_us < entry.min_interval_us) {
+            continue;
+        }
+        // Rate limit counts attempts, a failing transport is not retried every tick
+        entry.last_send_us = now_us;
+        entry.has_sent = true;
+        if (entry.transport->sendFrame(data)) {
+            sent_mask |= bit;
+        }
+    }
+    return sent_mask;
+}
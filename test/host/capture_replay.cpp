@@ -0,0 +1,94 @@
+#include "capture_replay.h"
+#include "gamepad_struct_converter.h"
+#include "joystick_shield.h"
+#include "pin_config.h"
+
+namespace
+{
+// Pins read by ReadButtonMask in ButtonMask bit order, pressed buttons pull pins low
+constexpr uint8_t kButtonPins[ButtonMask::kButtonCount] = {
+    Board::ButtonA::kNumber, Board::ButtonB::kNumber, Board::ButtonC::kNumber, Board::ButtonD::kNumber,
+    Board::ButtonE::kNumber, Board::ButtonF::kNumber, Board::JoystickButton::kNumber
+};
+
+void applyRecordToPins(const CaptureRecord& record) {
+    auto& state = Hal::Host::state();
+    state.adc[Board::JoystickX::kNumber] = record.x_raw;
+    state.adc[Board::JoystickY::kNumber] = record.y_raw;
+    for (uint8_t i = 0; i < ButtonMask::kButtonCount; ++i) {
+        const uint32_t bit = 1UL << kButtonPins[i];
+        if (record.buttons & (1U << i)) {
+            state.levels &= ~bit;
+        } else {
+            state.levels |= bit;
+        }
+    }
+}
+}   // namespace
+
+size_t CaptureReplay::extractRecords(const uint8_t* data, size_t size, std::vector<CaptureRecord>* records) {
+    size_t skipped = 0;
+    size_t position = 0;
+    while (position < size) {
+        uint8_t buffer[InputCapture::kRecordSize];
+        CaptureRecord record;
+        if (size - position >= InputCapture::kRecordSize) {
+            memcpy(buffer, data + position, sizeof(buffer));
+            if (InputCapture::Decode(buffer, &record)) {
+                records->push_back(record);
+                position += sizeof(buffer);
+                continue;
+            }
+        }
+        ++skipped;
+        ++position;
+    }
+    return skipped;
+}
+
+CaptureReplay::Pipeline::Pipeline(const CalibrationData& calibration, InputMapping::ProfileId profile):
+        calibration_(calibration),
+        profile_(profile),
+        controller_(Board::Radio::CePin::kNumber, Board::Radio::CsnPin::kNumber),
+        receiver_(0, 1),
+        time_offset_us_(0),
+        last_time_us_(0),
+        has_time_(false) {
+    controller_.init();
+    receiver_.init();
+    uint8_t address[RF24Driver::kAddressSize];
+    memcpy(address, RF24Driver::address_tx, sizeof(address));
+    receiver_.setRxAddress(RF24Driver::kFirstRxPipe, address);
+    receiver_.pollControllers();
+}
+
+CaptureReplay::Frame CaptureReplay::Pipeline::process(const CaptureRecord& record) {
+    if (has_time_ && record.time_us < last_time_us_) {
+        time_offset_us_ += 1UL << 32;
+    }
+    has_time_ = true;
+    last_time_us_ = record.time_us;
+    // Air time of previous frame may already have moved the clock past the record
+    const unsigned long record_us = time_offset_us_ + record.time_us;
+    if (record_us > ArduinoHost::peekMicros()) {
+        ArduinoHost::setMicros(record_us);
+    }
+
+    Frame frame = {};
+    frame.record = record;
+    applyRecordToPins(record);
+    ReadJoystickData(&frame.joystick, &calibration_);
+    button_events_.Update(ReadButtonMask(), record.time_us);
+    ButtonEvent event;
+    while (button_events_.PopEvent(&event)) {
+    }
+    frame.debounced_buttons = button_events_.GetState();
+
+    PadData pad_data{};
+    pad_data.joystick = frame.joystick;
+    UnpackButtonStates(frame.debounced_buttons, &pad_data.buttons);
+    convertGamepadDataToBP32(frame.sent, pad_data, profile_);
+    frame.is_sent = controller_.sendGamepadData(frame.sent);
+    frame.is_received = receiver_.receiveGamepadData(frame.received);
+    return frame;
+}
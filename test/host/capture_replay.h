@@ -0,0 +1,54 @@
+/*
+    Replay of InputCapture streams through the controller input pipeline on the host:
+    records -> ADC / button pins -> ReadJoystickData (ApplyJoystickCalibration) ->
+    ButtonEvents debounce -> convertGamepadDataToBP32 -> nRF24 chunks -> receiver reassembly.
+    Shared by the replay_capture tool and its test.
+*/
+#pragma once
+
+#include "input_capture.h"
+#include "input_mapping.h"
+#include "button_events.h"
+#include "nrf24_driver.h"
+
+#include <vector>
+
+namespace CaptureReplay
+{
+// Extract records from a raw serial dump, bytes which do not form a valid record are skipped
+// @return number of skipped bytes
+size_t extractRecords(const uint8_t* data, size_t size, std::vector<CaptureRecord>* records);
+
+// Result of one replayed record
+struct Frame {
+    CaptureRecord record;
+    JoystickData joystick;
+    uint8_t debounced_buttons;
+    BP32Data::PackedControllerData sent;
+    bool is_sent;                           // every chunk was acknowledged
+    bool is_received;                       // receiver published a frame for this record
+    BP32Data::PackedControllerData received;
+};
+
+class Pipeline
+{
+public:
+    // @param calibration: calibration used by ApplyJoystickCalibration, calibrated == false centers only
+    Pipeline(const CalibrationData& calibration, InputMapping::ProfileId profile);
+
+    // Run record through the pipeline, records have to be passed in capture order
+    Frame process(const CaptureRecord& record);
+
+    const RF24Driver::LinkStats& controllerLinkStats() const { return controller_.getLinkStats(); }
+
+private:
+    CalibrationData calibration_;
+    InputMapping::ProfileId profile_;
+    ButtonEvents button_events_;
+    RF24Driver::NRF24Controller controller_;
+    RF24Driver::NRF24Controller receiver_;
+    unsigned long time_offset_us_;      // extends 32 bit capture time over its wrap
+    uint32_t last_time_us_;
+    bool has_time_;
+};
+}   // namespace CaptureReplay
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""Generate imu_tilt_trace.csv, an MPU-6050 trace with known true gravity direction.
+
+Controller is tilted in pitch and roll while the sensor adds gyro bias, noise,
+vibration, sample time jitter and one dropped read, like the real board at 100 Hz.
+Columns: time_us, raw accel x y z, raw gyro x y z (counts of +-4 G / +-500 deg/s),
+true gravity x y z in milli-G. Traces recorded from hardware use the first 7 columns.
+"""
+import math
+import random
+
+ACCEL_COUNTS_PER_G = 8192
+GYRO_COUNTS_PER_DPS = 65.5
+GYRO_BIAS = (30, -18, 12)       # counts, ~0.5 deg/s
+SUBSTEPS = 20
+
+# (duration s, rate x dps, rate y dps, rate z dps, accel noise G)
+SEGMENTS = [
+    (3.0, 0, 0, 0, 0.005),
+    (2.0, 0, 15, 0, 0.005),     # pitch up 30 deg
+    (5.0, 0, 0, 0, 0.005),
+    (2.0, -10, 0, 0, 0.005),    # roll -20 deg
+    (5.0, 0, 0, 20, 0.08),      # yaw while motors vibrate
+    (3.0, 10, -10, -33.3, 0.005),  # tilt back while turning
+    (5.0, 0, 0, 0, 0.005),
+]
+
+
+def cross(a, b):
+    return (a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0])
+
+
+def clamp16(value):
+    return max(-32768, min(32767, int(round(value))))
+
+
+def main():
+    rng = random.Random(36)
+    gravity = (0.0, 0.0, 1.0)
+    time_us = 0
+    rows = []
+    for duration, wx, wy, wz, accel_noise in SEGMENTS:
+        end_us = time_us + int(duration * 1e6)
+        rate = (math.radians(wx), math.radians(wy), math.radians(wz))
+        while time_us < end_us:
+            dt_us = 10000 + rng.randint(-600, 600)
+            if len(rows) == 1200:
+                dt_us = 45000     # one read missed while controller was busy
+            # Gravity is fixed in world frame, in body frame dg/dt = g x w
+            step = dt_us / 1e6 / SUBSTEPS
+            for _ in range(SUBSTEPS):
+                change = cross(gravity, rate)
+                gravity = tuple(g + c * step for g, c in zip(gravity, change))
+                norm = math.sqrt(sum(g * g for g in gravity))
+                gravity = tuple(g / norm for g in gravity)
+            time_us += dt_us
+            accel = [clamp16((g + rng.gauss(0, accel_noise)) * ACCEL_COUNTS_PER_G) for g in gravity]
+            gyro = [clamp16(math.degrees(w) * GYRO_COUNTS_PER_DPS + bias + rng.gauss(0, 6))
+                    for w, bias in zip(rate, GYRO_BIAS)]
+            truth = [int(round(g * 1000)) for g in gravity]
+            rows.append([time_us] + accel + gyro + truth)
+
+    with open("imu_tilt_trace.csv", "w") as out:
+        out.write("# time_us,ax,ay,az,gx,gy,gz,true_gx_mg,true_gy_mg,true_gz_mg\n")
+        for row in rows:
+            out.write(",".join(str(value) for value in row) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,100 @@
+/*
+    Replay a raw input capture through the controller pipeline and the nRF24 link.
+    Input is the serial dump taken while "set cap 1" was active, text around records is skipped.
+    Prints one CSV line per record to stdout and a summary to stderr.
+
+    Usage: replay_capture [-p profile] [-c x_center,y_center,x_min,x_max,y_min,y_max] capture.bin
+      profile: 0 arcade (default), 1 tank, 2 camera
+      without -c raw values are only centered, like an uncalibrated controller
+*/
+#include "capture_replay.h"
+#include "test_support.h"
+
+#include <vector>
+
+namespace
+{
+int usage() {
+    fprintf(stderr, "usage: replay_capture [-p profile] [-c xc,yc,xmin,xmax,ymin,ymax] capture.bin\n");
+    return 2;
+}
+
+bool readFile(const char* path, std::vector<uint8_t>* data) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data->insert(data->end(), buffer, buffer + count);
+    }
+    fclose(file);
+    return true;
+}
+}   // namespace
+
+int main(int argc, char** argv) {
+    CalibrationData calibration = {};
+    InputMapping::ProfileId profile = InputMapping::ProfileId::kArcade;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            const int value = atoi(argv[++i]);
+            if (value < 0 || value >= static_cast<int>(InputMapping::ProfileId::kCount)) {
+                return usage();
+            }
+            profile = static_cast<InputMapping::ProfileId>(value);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d,%d,%d,%d,%d,%d", &calibration.x_center, &calibration.y_center,
+                       &calibration.x_min, &calibration.x_max, &calibration.y_min, &calibration.y_max) != 6) {
+                return usage();
+            }
+            calibration.calibrated = true;
+        } else if (path == nullptr && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            return usage();
+        }
+    }
+    if (path == nullptr) {
+        return usage();
+    }
+
+    std::vector<uint8_t> data;
+    if (!readFile(path, &data)) {
+        fprintf(stderr, "Unable to read %s\n", path);
+        return 1;
+    }
+    HostTest::resetWorld();
+    std::vector<CaptureRecord> records;
+    const size_t skipped = CaptureReplay::extractRecords(data.data(), data.size(), &records);
+
+    CaptureReplay::Pipeline pipeline(calibration, profile);
+    unsigned int received = 0;
+    unsigned int mismatched = 0;
+    printf("time_us,x_raw,y_raw,raw_buttons,buttons,x_cal,y_cal,axis_x,axis_y,axis_rx,axis_ry,"
+           "brake,throttle,frame_buttons,misc_buttons,sent,received\n");
+    for (const CaptureRecord& record : records) {
+        const CaptureReplay::Frame frame = pipeline.process(record);
+        const BP32Data::PackedControllerData& sent = frame.sent;
+        printf("%u,%u,%u,%u,%u,%d,%d,%d,%d,%d,%d,%d,%d,%u,%u,%d,%d\n",
+               record.time_us, record.x_raw, record.y_raw, record.buttons, frame.debounced_buttons,
+               frame.joystick.x_calibrated, frame.joystick.y_calibrated,
+               static_cast<int>(sent.axis_x), static_cast<int>(sent.axis_y),
+               static_cast<int>(sent.axis_rx), static_cast<int>(sent.axis_ry),
+               static_cast<int>(sent.brake), static_cast<int>(sent.throttle),
+               sent.buttons, sent.misc_buttons, frame.is_sent ? 1 : 0, frame.is_received ? 1 : 0);
+        if (frame.is_received) {
+            ++received;
+            if (memcmp(&frame.received, &frame.sent, sizeof(frame.sent)) != 0) {
+                ++mismatched;
+            }
+        }
+    }
+    const RF24Driver::LinkStats& link = pipeline.controllerLinkStats();
+    fprintf(stderr, "records %zu, skipped bytes %zu, frames sent %lu failed %lu, received %u, mismatched %u\n",
+            records.size(), skipped, static_cast<unsigned long>(link.frames_sent),
+            static_cast<unsigned long>(link.frames_failed), received, mismatched);
+    return mismatched == 0 ? 0 : 1;
+}
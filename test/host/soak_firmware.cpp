@@ -0,0 +1,478 @@
+/*
+    Soak run of the complete firmware: setup() and loop() of src/main.cpp on the virtual clock,
+    sending to a receiver on the simulated air. A repeating script moves the stick, chatters a button,
+    drops radio attempts, blacks out the link and sags the battery. Invariants are checked on every
+    tick, a throughput and latency summary is printed at the end.
+    Built twice: radio with serial console (soak_firmware) and with BLE serial (soak_firmware_ble),
+    where a fake module and robot answer on Serial and the mode switch moves control to BLE.
+    Firmware time is 32 bits wide as on AVR, the script runs on time since start of the run, so a run
+    started just before micros() or millis() wraps checks the firmware across the wrap.
+    Usage: soak_firmware [seconds] [seed] [start_ms]
+*/
+#include "test_support.h"
+#include "config.h"
+#include "pin_config.h"
+#include "nrf24_driver.h"
+#include "joystick_shield_struct.h"
+
+#include <string>
+
+// Firmware entry points and state of src/main.cpp
+void setup();
+void loop();
+extern JoystickData joystick_data;
+extern ButtonStates button_states;
+extern CalibrationData calibration_data;
+extern BP32Data::PackedControllerData controller_data;
+
+namespace
+{
+#ifdef ENABLE_BLE_SERIAL
+constexpr char kName[] = "soak_firmware_ble";
+#else
+constexpr char kName[] = "soak_firmware";
+#endif
+constexpr int kReceiverCePin = 22;
+constexpr int kReceiverCsnPin = 23;
+
+// Script repeats every cycle, times are relative to cycle start
+constexpr unsigned long kCycleMs = 15000;
+constexpr unsigned long kCenterHoldMs = 1000;       // stick centered for boot calibration
+constexpr unsigned long kLossStartMs = 1000;        // random loss of single attempts, retries cover it
+constexpr unsigned long kLossEndMs = 3000;
+constexpr uint32_t kLossPercent = 20;
+constexpr unsigned long kBlackoutStartMs = 4000;    // longer than failsafe timeout
+constexpr unsigned long kBlackoutEndMs = 4400;
+constexpr unsigned long kGlitchStartMs = 5500;      // shorter than failsafe timeout
+constexpr unsigned long kGlitchEndMs = 5650;
+constexpr unsigned long kChatterStartMs = 7000;     // button A bounces on every sample, then is held
+constexpr unsigned long kChatterEndMs = 7040;
+constexpr unsigned long kPressEndMs = 7400;
+constexpr unsigned long kSagStartMs = 8000;         // battery drops into low state and recovers
+constexpr unsigned long kSagEndMs = 14000;
+#ifdef ENABLE_BLE_SERIAL
+constexpr unsigned long kBleModeStartMs = 9000;     // mode switch selects BLE, radio goes quiet
+constexpr unsigned long kBleModeEndMs = 12500;
+constexpr unsigned long kRobotSilentStartMs = 10000;    // robot heartbeats stop, BLE link times out
+constexpr unsigned long kRobotSilentEndMs = 12000;
+constexpr unsigned long kHeartbeatPeriodMs = 500;
+constexpr unsigned long kBleHeartbeatTimeoutMs = 1500;  // BluetoothTransmitter::kHeartbeatTimeoutMs
+constexpr unsigned long kBleBaudRate = 38400;
+#endif
+
+constexpr uint16_t kBatteryNormalMv = 4000;
+constexpr uint16_t kBatterySagMv = 3450;    // filtered voltage passes low state, never reaches critical
+
+// Worst case blocking of one failed frame: every chunk exhausts its retries
+constexpr unsigned long kFailedSendMaxUs = 70000;
+// Input to last chunk on air, clean link sends every chunk once, lossy link may use all retries
+constexpr unsigned long kMaxLatencyUs = 2000;
+constexpr uint8_t kMaxReportedViolations = 10;
+
+uint16_t millivoltsToAdc(uint16_t millivolts) {
+    return static_cast<uint16_t>(millivolts * 1023UL / (kBatteryAdcReferenceMv * kBatteryDividerRatio));
+}
+
+bool isWithin(unsigned long time_ms, unsigned long start_ms, unsigned long end_ms) {
+    return time_ms >= start_ms && time_ms < end_ms;
+}
+
+// Deterministic noise, runs are reproducible from the seed
+class Random
+{
+public:
+    explicit Random(uint32_t seed): state_(seed != 0 ? seed : 1) {}
+
+    uint32_t next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return state_;
+    }
+
+private:
+    uint32_t state_;
+};
+
+// Inputs and link conditions of the current tick
+struct Conditions {
+    bool is_blackout;
+    uint32_t loss_percent;
+    bool is_ble_mode;
+    bool is_robot_silent;
+};
+
+Conditions applyScript(unsigned long now_ms, unsigned long tick, Random& random) {
+    const unsigned long t = now_ms % kCycleMs;
+    auto& pins = Hal::Host::state();
+
+    // X sweeps the full range in 2 s, Y swings around center in 3 s, both with a little ADC noise
+    uint16_t x_adc = 512;
+    uint16_t y_adc = 512;
+    if (now_ms >= kCenterHoldMs) {
+        const unsigned long phase = now_ms % 2000;
+        x_adc = static_cast<uint16_t>(phase < 1000 ? phase * 1023 / 1000 : (2000 - phase) * 1023 / 1000);
+        y_adc = static_cast<uint16_t>(512 + 400 * sin(2.0 * M_PI * (now_ms % 3000) / 3000.0));
+    }
+    const int noise = static_cast<int>(random.next() % 7) - 3;
+    pins.adc[JOYSTICK_X_PIN] = static_cast<uint16_t>(constrain(x_adc + noise, 0, 1023));
+    pins.adc[JOYSTICK_Y_PIN] = static_cast<uint16_t>(constrain(y_adc - noise, 0, 1023));
+
+    // Buttons are active low
+    bool is_a_pressed = false;
+    if (isWithin(t, kChatterStartMs, kChatterEndMs)) {
+        is_a_pressed = tick & 1U;
+    } else if (isWithin(t, kChatterEndMs, kPressEndMs)) {
+        is_a_pressed = true;
+    }
+    const uint32_t a_bit = 1UL << A_PIN;
+    pins.levels = is_a_pressed ? (pins.levels & ~a_bit) : (pins.levels | a_bit);
+
+    const bool is_sag = isWithin(t, kSagStartMs, kSagEndMs);
+    pins.adc[VOLTAGE_MONITOR_PIN] = millivoltsToAdc(is_sag ? kBatterySagMv : kBatteryNormalMv);
+
+    Conditions conditions{};
+    conditions.is_blackout = isWithin(t, kBlackoutStartMs, kBlackoutEndMs) || isWithin(t, kGlitchStartMs, kGlitchEndMs);
+    conditions.loss_percent = isWithin(t, kLossStartMs, kLossEndMs) ? kLossPercent : 0;
+#ifdef ENABLE_BLE_SERIAL
+    conditions.is_ble_mode = isWithin(t, kBleModeStartMs, kBleModeEndMs);
+    conditions.is_robot_silent = isWithin(t, kRobotSilentStartMs, kRobotSilentEndMs);
+#endif
+    const uint32_t switch_bit = 1UL << SWITCH_TRANSMISSION_MODE_PIN;
+    pins.levels = conditions.is_ble_mode ? (pins.levels & ~switch_bit) : (pins.levels | switch_bit);
+    return conditions;
+}
+
+// Counters of the whole run
+struct Summary {
+    unsigned long ticks = 0;
+    unsigned long frames_received = 0;
+    unsigned long latency_sum_us = 0;
+    unsigned long latency_max_us = 0;
+    unsigned long failsafe_entries = 0;
+    unsigned long recoveries = 0;
+    unsigned long recovery_max_ticks = 0;
+    unsigned long low_battery_ticks = 0;
+    unsigned long button_presses = 0;
+    unsigned long button_releases = 0;
+    unsigned long tick_max_us = 0;
+    unsigned long ble_commands = 0;
+    unsigned long ble_connected_ms = 0;
+    unsigned long ble_bytes = 0;
+    unsigned long violations = 0;
+};
+
+Summary summary;
+
+// Time of report is time since start of the run
+void violation(unsigned long elapsed_us, const char* what, long value = 0) {
+    if (summary.violations++ < kMaxReportedViolations) {
+        printf("%lu.%03lu s: %s (%ld)\n", elapsed_us / 1000000UL, elapsed_us / 1000UL % 1000UL, what, value);
+    }
+    ++HostTest::failures();
+}
+
+#ifdef ENABLE_BLE_SERIAL
+// HM-10 module answering AT commands and a robot sending heartbeats, pad commands are checked.
+// Robot has its own clock, time since start of the run.
+class FakeBleRobot
+{
+public:
+    // @return number of pad commands found in firmware output since last call
+    unsigned long update(unsigned long now_us, const Conditions& conditions) {
+        const unsigned long now_ms = now_us / 1000UL;
+        pending_.append(Serial.hostOutput(), Serial.hostOutputSize());
+        Serial.hostClearOutput();
+
+        unsigned long commands = 0;
+        size_t position = 0;
+        while (position < pending_.size()) {
+            if (pending_.compare(position, 2, "AT") == 0) {
+                // Module commands are not terminated, "AT+BAUD3" or "AT"
+                position += pending_.compare(position, 8, "AT+BAUD3") == 0 ? 8 : 2;
+                Serial.hostWrite("OK");
+                continue;
+            }
+            const size_t end = pending_.find('*', position);
+            if (end == std::string::npos) {
+                break;
+            }
+            const std::string command = pending_.substr(position, end - position);
+            if (command == "A" || command == "B") {
+                // Angle offset of button A / B, sent on press in any mode
+                ++angle_commands_;
+            } else {
+                checkPadCommand(now_us, now_ms, conditions, command);
+                ++commands;
+            }
+            position = end + 1;
+        }
+        pending_.erase(0, position);
+
+        if (!conditions.is_robot_silent && now_ms - last_heartbeat_ms_ >= kHeartbeatPeriodMs) {
+            Serial.hostWrite("H*");
+            last_heartbeat_ms_ = now_ms;
+        }
+        return commands;
+    }
+
+    bool isLinkExpected(unsigned long now_ms) const {
+        return now_ms - last_heartbeat_ms_ < kBleHeartbeatTimeoutMs;
+    }
+
+    unsigned long angleCommands() const { return angle_commands_; }
+
+private:
+    void checkPadCommand(unsigned long now_us, unsigned long now_ms, const Conditions& conditions,
+                         const std::string& command) {
+        int x_value = 0;
+        int y_value = 0;
+        int length = 0;
+        if (sscanf(command.c_str(), "SX%dY%d%n", &x_value, &y_value, &length) != 2 ||
+            length != static_cast<int>(command.size())) {
+            violation(now_us, "malformed BLE command", static_cast<long>(command.size()));
+            return;
+        }
+        if (!conditions.is_ble_mode) {
+            violation(now_us, "BLE command outside BLE mode");
+        }
+        if (!isLinkExpected(now_ms) && now_ms - last_heartbeat_ms_ > kBleHeartbeatTimeoutMs + 2 * kMainLoopCycleTimeUs / 1000) {
+            violation(now_us, "BLE command without heartbeat", static_cast<long>(now_ms - last_heartbeat_ms_));
+        }
+        // Robot is steered by the calibrated stick of the same tick
+        const int expected_x = constrain(joystick_data.x_calibrated >> 2, -127, 127);
+        const int expected_y = constrain(joystick_data.y_calibrated >> 2, -127, 127);
+        if (x_value != expected_x || y_value != expected_y) {
+            violation(now_us, "BLE command does not match stick", x_value - expected_x);
+        }
+        if (has_command_ && now_us - last_command_us_ + kMainLoopCycleTimeUs / 10 < kBleMinFrameIntervalUs) {
+            violation(now_us, "BLE commands faster than rate limit", static_cast<long>(now_us - last_command_us_));
+        }
+        has_command_ = true;
+        last_command_us_ = now_us;
+    }
+
+    std::string pending_;
+    unsigned long angle_commands_ = 0;
+    unsigned long last_heartbeat_ms_ = 0;
+    unsigned long last_command_us_ = 0;
+    bool has_command_ = false;
+};
+#endif
+}   // namespace
+
+int main(int argc, char** argv) {
+    const unsigned long duration_s = argc > 1 ? strtoul(argv[1], nullptr, 10) : 60;
+    const uint32_t seed = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 1;
+    const uint64_t start_ms = argc > 3 ? strtoull(argv[3], nullptr, 10) : 0;
+    Random random(seed);
+
+    HostTest::resetWorld();
+    ArduinoHost::setMicros(start_ms * 1000U);
+    const uint32_t run_start_us = ArduinoHost::peekMicros();
+#ifdef ENABLE_BLE_SERIAL
+    // Firmware does not start the log when BLE owns the UART
+    Log.begin(LOG_LEVEL_SILENT, nullptr, false);
+#else
+    // Log goes to the console port, only its volume is of interest
+    Serial.hostSetOutputLimit(0);
+#endif
+
+    RF24Driver::NRF24Controller receiver(kReceiverCePin, kReceiverCsnPin);
+    if (!receiver.init()) {
+        printf("receiver init failed\n");
+        return 1;
+    }
+    uint8_t address[RF24Driver::kAddressSize];
+    memcpy(address, RF24Driver::address_tx, sizeof(address));
+    receiver.setRxAddress(RF24Driver::kFirstRxPipe, address);
+    receiver.pollControllers();     // receiver starts listening on its first poll
+
+    Conditions conditions{};
+    uint32_t last_delivery_us = 0;
+    RF24Host::setLossHook([&](const RF24& sender, const uint8_t*, uint8_t, uint8_t) {
+        if (sender.hostCePin() != NRF24L01_CE_PIN) {
+            return false;
+        }
+        const bool is_lost = conditions.is_blackout ||
+                             (conditions.loss_percent > 0 && random.next() % 100 < conditions.loss_percent);
+        if (!is_lost) {
+            last_delivery_us = ArduinoHost::peekMicros();
+        }
+        return is_lost;
+    });
+
+    Hal::Host::state().adc[JOYSTICK_X_PIN] = 512;
+    Hal::Host::state().adc[JOYSTICK_Y_PIN] = 512;
+    Hal::Host::state().adc[VOLTAGE_MONITOR_PIN] = millivoltsToAdc(kBatteryNormalMv);
+    setup();
+    const uint32_t setup_end_us = ArduinoHost::peekMicros();
+    const unsigned long string_allocations = ArduinoHost::stringTotalAllocations();
+    const unsigned long serial_bytes = Serial.hostBytesWritten();
+#ifdef ENABLE_BLE_SERIAL
+    FakeBleRobot robot;
+#endif
+
+    const BP32Data::FailsafeConfig failsafe = BP32Data::kDefaultFailsafeConfig;
+    const unsigned long failsafe_timeout_us = failsafe.timeout_ms * 1000UL;
+    // Firmware time wraps, time since start of the run is accumulated tick by tick
+    const unsigned long setup_elapsed_us = setup_end_us - run_start_us;
+    const unsigned long end_elapsed_us = setup_elapsed_us + duration_s * 1000000UL;
+    unsigned long elapsed_us = setup_elapsed_us;
+    uint32_t last_rx_us = setup_end_us;     // air time of last frame the receiver published
+    unsigned long link_up_ticks = 0;
+    bool is_failsafe = true;        // receiver slot starts in failsafe
+    bool was_a_pressed = false;
+    uint32_t tick_start_us = setup_end_us;
+
+    while (elapsed_us < end_elapsed_us) {
+        const uint32_t start_us = ArduinoHost::peekMicros();
+        conditions = applyScript(elapsed_us / 1000UL, summary.ticks, random);
+        const bool is_link_up = !conditions.is_blackout && !conditions.is_ble_mode;
+        link_up_ticks = is_link_up ? link_up_ticks + 1 : 0;
+
+        const uint32_t delivery_before_us = last_delivery_us;
+        loop();
+        ++summary.ticks;
+        const uint32_t now_us = ArduinoHost::peekMicros();
+
+        // Tick period, a failed send may stretch one tick
+        const uint32_t tick_us = now_us - tick_start_us;
+        tick_start_us = now_us;
+        elapsed_us += tick_us;
+        summary.tick_max_us = max(summary.tick_max_us, static_cast<unsigned long>(tick_us));
+        if (tick_us > kLowBatteryLoopCycleTimeUs + kFailedSendMaxUs) {
+            violation(elapsed_us, "tick overran", static_cast<long>(tick_us));
+        }
+        // Ticks are never early, also not when micros() wraps between two of them
+        if (summary.ticks > 1 && tick_us + kMainLoopCycleTimeUs / 10 < kMainLoopCycleTimeUs) {
+            violation(elapsed_us, "tick ran early", static_cast<long>(tick_us));
+        }
+        if (Hal::Host::state().levels & (1UL << LOW_VOLTAGE_LED_PIN)) {
+            ++summary.low_battery_ticks;
+        }
+
+        // Debounced button follows the script exactly once per press despite chatter
+        if (button_states.button_a != was_a_pressed) {
+            ++(button_states.button_a ? summary.button_presses : summary.button_releases);
+            was_a_pressed = button_states.button_a;
+        }
+
+        BP32Data::PackedControllerData received;
+        if (receiver.receiveGamepadData(received)) {
+            if (received.id < 0) {
+                ++summary.failsafe_entries;
+                if (now_us - last_rx_us < failsafe_timeout_us) {
+                    violation(elapsed_us, "failsafe before timeout", static_cast<long>(now_us - last_rx_us));
+                }
+                is_failsafe = true;
+            } else {
+                ++summary.frames_received;
+                if (received.axis_x != controller_data.axis_x || received.axis_y != controller_data.axis_y ||
+                    received.axis_rx != controller_data.axis_rx || received.axis_ry != controller_data.axis_ry ||
+                    received.brake != controller_data.brake || received.throttle != controller_data.throttle ||
+                    received.buttons != controller_data.buttons || received.misc_buttons != controller_data.misc_buttons ||
+                    received.dpad != controller_data.dpad) {
+                    violation(elapsed_us, "received frame differs from frame of this tick", received.axis_x - controller_data.axis_x);
+                }
+                if (abs(received.axis_x) > 512 || abs(received.axis_y) > 512) {
+                    violation(elapsed_us, "axis out of range", received.axis_x);
+                }
+                const uint32_t latency_us = last_delivery_us - start_us;
+                const unsigned long max_latency_us = conditions.loss_percent > 0 ? kFailedSendMaxUs : kMaxLatencyUs;
+                if (last_delivery_us == delivery_before_us || latency_us > max_latency_us) {
+                    violation(elapsed_us, "frame latency", static_cast<long>(latency_us));
+                }
+                summary.latency_sum_us += latency_us;
+                summary.latency_max_us = max(summary.latency_max_us, static_cast<unsigned long>(latency_us));
+                if (is_failsafe) {
+                    ++summary.recoveries;
+                    summary.recovery_max_ticks = max(summary.recovery_max_ticks, link_up_ticks);
+                    is_failsafe = false;
+                }
+                last_rx_us = last_delivery_us;
+            }
+        } else if (link_up_ticks > failsafe.recovery_frames) {
+            // Retries cover single lost attempts, a working link delivers every tick
+            violation(elapsed_us, "no frame on working link", static_cast<long>(link_up_ticks));
+        }
+        if (!is_failsafe && now_us - last_rx_us > failsafe_timeout_us + kFailedSendMaxUs + kLowBatteryLoopCycleTimeUs) {
+            violation(elapsed_us, "link lost without failsafe", static_cast<long>(now_us - last_rx_us));
+        }
+
+#ifdef ENABLE_BLE_SERIAL
+        summary.ble_commands += robot.update(elapsed_us, conditions);
+        if (conditions.is_ble_mode && robot.isLinkExpected(elapsed_us / 1000UL)) {
+            summary.ble_connected_ms += tick_us / 1000UL;
+        }
+#endif
+    }
+
+    // Heap is never touched after setup, long runs can not fragment it
+    const unsigned long loop_allocations = ArduinoHost::stringTotalAllocations() - string_allocations;
+    if (loop_allocations != 0) {
+        violation(elapsed_us, "String allocations in loop", static_cast<long>(loop_allocations));
+    }
+    if (!calibration_data.calibrated) {
+        violation(elapsed_us, "boot calibration did not finish");
+    }
+
+    // Every complete cycle has one long blackout, one button press and one battery sag
+    const unsigned long cycles = duration_s * 1000UL / kCycleMs;
+    if (summary.button_presses < cycles || summary.button_presses > cycles + 1 ||
+        summary.button_releases < cycles) {
+        violation(elapsed_us, "button presses", static_cast<long>(summary.button_presses));
+    }
+#ifdef ENABLE_BLE_SERIAL
+    // Radio is off in BLE mode, receiver falls into failsafe for that too
+    const unsigned long expected_failsafe = 2 * cycles;
+#else
+    const unsigned long expected_failsafe = cycles;
+#endif
+    if (summary.failsafe_entries < expected_failsafe || summary.failsafe_entries > expected_failsafe + 2) {
+        violation(elapsed_us, "failsafe entries", static_cast<long>(summary.failsafe_entries));
+    }
+    if (cycles > 1 && summary.low_battery_ticks == 0) {
+        violation(elapsed_us, "battery sag not detected");
+    }
+    if (summary.recovery_max_ticks > failsafe.recovery_frames + 1U) {
+        violation(elapsed_us, "slow failsafe recovery", static_cast<long>(summary.recovery_max_ticks));
+    }
+
+    const double seconds = (elapsed_us - setup_elapsed_us) / 1e6;
+    const RF24Host::Stats& air = RF24Host::stats();
+    printf("%lu ticks in %.1f s simulated, seed %u, max tick %lu us\n",
+           summary.ticks, seconds, static_cast<unsigned>(seed), summary.tick_max_us);
+    printf("radio: %lu frames received (%.1f/s), latency avg %lu us max %lu us\n",
+           summary.frames_received, summary.frames_received / seconds,
+           summary.frames_received > 0 ? summary.latency_sum_us / summary.frames_received : 0,
+           summary.latency_max_us);
+    printf("air: %lu attempts, %lu lost, %lu fifo full; failsafe %lu entries, %lu recoveries (max %lu ticks)\n",
+           air.attempts, air.lost, air.fifo_full, summary.failsafe_entries, summary.recoveries,
+           summary.recovery_max_ticks);
+    printf("inputs: %lu presses, %lu releases; low battery %lu ticks; String allocations in loop %lu\n",
+           summary.button_presses, summary.button_releases, summary.low_battery_ticks, loop_allocations);
+#ifdef ENABLE_BLE_SERIAL
+    summary.ble_bytes = Serial.hostBytesWritten() - serial_bytes;
+    const double ble_bytes_per_s = summary.ble_bytes / seconds;
+    printf("ble: %lu commands (%.1f/s while connected), %.0f B/s of %lu B/s\n",
+           summary.ble_commands,
+           summary.ble_connected_ms > 0 ? summary.ble_commands * 1000.0 / summary.ble_connected_ms : 0.0,
+           ble_bytes_per_s, kBleBaudRate / 10);
+    if (robot.angleCommands() != summary.button_presses) {
+        violation(elapsed_us, "angle offset commands", static_cast<long>(robot.angleCommands()));
+    }
+    if (cycles > 0 && summary.ble_commands == 0) {
+        violation(elapsed_us, "no BLE commands");
+    }
+    if (ble_bytes_per_s > kBleBaudRate / 10) {
+        violation(elapsed_us, "BLE output exceeds baud rate", static_cast<long>(ble_bytes_per_s));
+    }
+#else
+    printf("serial: %.0f B/s\n", (Serial.hostBytesWritten() - serial_bytes) / seconds);
+#endif
+    if (summary.violations > kMaxReportedViolations) {
+        printf("%lu violations in total\n", summary.violations);
+    }
+    return HostTest::finish(kName);
+}
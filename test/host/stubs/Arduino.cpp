@@ -0,0 +1,326 @@
+#include <Arduino.h>
+#include "hal_host_state.h"
+
+#include <string>
+
+HardwareSerial Serial;
+
+namespace
+{
+uint64_t now_us = 0;
+unsigned long call_cost_us = 4;     // roughly what micros() costs on 16 MHz AVR
+unsigned long string_live = 0;
+unsigned long string_total = 0;
+
+std::string serial_rx;
+size_t serial_rx_position = 0;
+std::string serial_tx;
+size_t serial_tx_limit = 1UL << 20;
+
+char* allocateString(char* buffer, unsigned int capacity) {
+    char* resized = static_cast<char*>(realloc(buffer, capacity + 1));
+    if (buffer == nullptr) {
+        string_live++;
+    }
+    string_total++;
+    return resized;
+}
+}   // namespace
+
+namespace ArduinoHost
+{
+void reset() {
+    now_us = 0;
+    call_cost_us = 4;
+    string_total = 0;
+    serial_rx.clear();
+    serial_rx_position = 0;
+    serial_tx.clear();
+    Hal::Host::state() = Hal::Host::State{0xFFFFFFFFUL, 0, 0, {}};
+}
+
+void setMicros(uint64_t value) { now_us = value; }
+void advanceMicros(uint32_t delta_us) { now_us += delta_us; }
+uint32_t peekMicros() { return static_cast<uint32_t>(now_us); }
+void setCallCostUs(unsigned long cost_us) { call_cost_us = cost_us; }
+
+unsigned long stringLiveAllocations() { return string_live; }
+unsigned long stringTotalAllocations() { return string_total; }
+}   // namespace ArduinoHost
+
+uint32_t micros() {
+    now_us += call_cost_us;
+    return static_cast<uint32_t>(now_us);
+}
+
+uint32_t millis() {
+    now_us += call_cost_us;
+    return static_cast<uint32_t>(now_us / 1000U);
+}
+
+void delay(unsigned long ms) { now_us += ms * 1000UL; }
+void delayMicroseconds(unsigned int us) { now_us += us; }
+void yield() {}
+
+int analogRead(uint8_t pin) { return Hal::Host::state().adc[pin & (Hal::Host::kPinCount - 1)]; }
+void analogReference(uint8_t) {}
+
+int digitalRead(uint8_t pin) {
+    return (Hal::Host::state().levels >> (pin & (Hal::Host::kPinCount - 1))) & 1U ? HIGH : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    const uint32_t mask = 1UL << (pin & (Hal::Host::kPinCount - 1));
+    if (value) {
+        Hal::Host::state().levels |= mask;
+    } else {
+        Hal::Host::state().levels &= ~mask;
+    }
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    const uint32_t mask = 1UL << (pin & (Hal::Host::kPinCount - 1));
+    Hal::Host::state().outputs &= ~mask;
+    Hal::Host::state().pullups &= ~mask;
+    if (mode == OUTPUT) {
+        Hal::Host::state().outputs |= mask;
+    } else if (mode == INPUT_PULLUP) {
+        Hal::Host::state().pullups |= mask;
+    }
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+void noInterrupts() {}
+void interrupts() {}
+
+// String
+
+String::String(const char* value): buffer_(nullptr), capacity_(0), length_(0) {
+    assign(value, value != nullptr ? strlen(value) : 0);
+}
+
+String::String(const String& other): buffer_(nullptr), capacity_(0), length_(0) {
+    assign(other.c_str(), other.length_);
+}
+
+String::String(String&& other) noexcept:
+    buffer_(other.buffer_), capacity_(other.capacity_), length_(other.length_) {
+    other.buffer_ = nullptr;
+    other.capacity_ = 0;
+    other.length_ = 0;
+}
+
+String::String(char value): buffer_(nullptr), capacity_(0), length_(0) {
+    assign(&value, 1);
+}
+
+String::String(int value, unsigned char base): String(static_cast<long>(value), base) {}
+String::String(unsigned int value, unsigned char base): String(static_cast<unsigned long>(value), base) {}
+
+String::String(long value, unsigned char base): buffer_(nullptr), capacity_(0), length_(0) {
+    char text[34];
+    if (base == 10) {
+        snprintf(text, sizeof(text), "%ld", value);
+    } else {
+        snprintf(text, sizeof(text), base == 16 ? "%lx" : "%lo", static_cast<unsigned long>(value));
+    }
+    assign(text, strlen(text));
+}
+
+String::String(unsigned long value, unsigned char base): buffer_(nullptr), capacity_(0), length_(0) {
+    char text[34];
+    snprintf(text, sizeof(text), base == 16 ? "%lx" : (base == 8 ? "%lo" : "%lu"), value);
+    assign(text, strlen(text));
+}
+
+String::~String() {
+    if (buffer_ != nullptr) {
+        free(buffer_);
+        string_live--;
+    }
+}
+
+String& String::operator=(const String& other) {
+    if (this != &other) {
+        assign(other.c_str(), other.length_);
+    }
+    return *this;
+}
+
+String& String::operator=(String&& other) noexcept {
+    if (this != &other) {
+        if (buffer_ != nullptr) {
+            free(buffer_);
+            string_live--;
+        }
+        buffer_ = other.buffer_;
+        capacity_ = other.capacity_;
+        length_ = other.length_;
+        other.buffer_ = nullptr;
+        other.capacity_ = 0;
+        other.length_ = 0;
+    }
+    return *this;
+}
+
+String& String::operator=(const char* value) {
+    assign(value, value != nullptr ? strlen(value) : 0);
+    return *this;
+}
+
+unsigned char String::reserve(unsigned int size) {
+    if (buffer_ != nullptr && capacity_ >= size) {
+        return 1;
+    }
+    char* resized = allocateString(buffer_, size);
+    if (resized == nullptr) {
+        return 0;
+    }
+    if (buffer_ == nullptr) {
+        resized[0] = '\0';
+    }
+    buffer_ = resized;
+    capacity_ = size;
+    return 1;
+}
+
+char String::operator[](unsigned int index) const {
+    return index < length_ ? buffer_[index] : '\0';
+}
+
+bool String::operator==(const String& other) const {
+    return length_ == other.length_ && strcmp(c_str(), other.c_str()) == 0;
+}
+
+bool String::operator==(const char* other) const {
+    return strcmp(c_str(), other != nullptr ? other : "") == 0;
+}
+
+String& String::concat(const char* value, unsigned int length) {
+    if (reserve(length_ + length)) {
+        memmove(buffer_ + length_, value, length);
+        length_ += length;
+        buffer_[length_] = '\0';
+    }
+    return *this;
+}
+
+String& String::operator+=(int value) { return *this += static_cast<long>(value); }
+String& String::operator+=(unsigned int value) { return *this += static_cast<unsigned long>(value); }
+
+String& String::operator+=(long value) {
+    char text[24];
+    snprintf(text, sizeof(text), "%ld", value);
+    return concat(text, strlen(text));
+}
+
+String& String::operator+=(unsigned long value) {
+    char text[24];
+    snprintf(text, sizeof(text), "%lu", value);
+    return concat(text, strlen(text));
+}
+
+void String::assign(const char* value, unsigned int length) {
+    if (!reserve(length)) {
+        return;
+    }
+    memmove(buffer_, value, length);
+    length_ = length;
+    buffer_[length_] = '\0';
+}
+
+// Print
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (size-- > 0) {
+        written += write(*buffer++);
+    }
+    return written;
+}
+
+size_t Print::print(const __FlashStringHelper* text) { return write(reinterpret_cast<const char*>(text)); }
+size_t Print::print(const String& text) { return write(text.c_str(), text.length()); }
+size_t Print::print(const char* text) { return write(text); }
+size_t Print::print(char value) { return write(static_cast<uint8_t>(value)); }
+size_t Print::print(unsigned char value, int base) { return printNumber(value, base); }
+size_t Print::print(unsigned int value, int base) { return printNumber(value, base); }
+size_t Print::print(unsigned long value, int base) { return printNumber(value, base); }
+size_t Print::print(int value, int base) { return print(static_cast<long>(value), base); }
+
+size_t Print::print(long value, int base) {
+    if (base == 10 && value < 0) {
+        return print('-') + printNumber(static_cast<unsigned long>(-(value + 1)) + 1UL, 10);
+    }
+    return printNumber(static_cast<unsigned long>(value), base);
+}
+
+size_t Print::print(double value, int digits) {
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return write(text);
+}
+
+size_t Print::println() { return write("\r\n"); }
+
+size_t Print::printNumber(unsigned long value, int base) {
+    char text[72];
+    char* cursor = &text[sizeof(text) - 1];
+    *cursor = '\0';
+    if (base < 2) {
+        base = 10;
+    }
+    do {
+        const unsigned long digit = value % base;
+        *--cursor = static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= base;
+    } while (value > 0);
+    return write(cursor);
+}
+
+// HardwareSerial
+
+void HardwareSerial::begin(unsigned long baud) {
+    is_open_ = true;
+    baud_ = baud;
+}
+
+void HardwareSerial::end() { is_open_ = false; }
+
+int HardwareSerial::available() { return static_cast<int>(serial_rx.size() - serial_rx_position); }
+
+int HardwareSerial::read() {
+    if (serial_rx_position >= serial_rx.size()) {
+        return -1;
+    }
+    const int value = static_cast<uint8_t>(serial_rx[serial_rx_position++]);
+    if (serial_rx_position == serial_rx.size()) {
+        serial_rx.clear();
+        serial_rx_position = 0;
+    }
+    return value;
+}
+
+int HardwareSerial::peek() {
+    return serial_rx_position < serial_rx.size() ? static_cast<uint8_t>(serial_rx[serial_rx_position]) : -1;
+}
+
+size_t HardwareSerial::write(uint8_t value) {
+    bytes_written_++;
+    if (serial_tx.size() < serial_tx_limit) {
+        serial_tx.push_back(static_cast<char>(value));
+    }
+    return 1;
+}
+
+void HardwareSerial::hostWrite(const char* text) { serial_rx.append(text); }
+void HardwareSerial::hostWrite(const uint8_t* data, size_t size) {
+    serial_rx.append(reinterpret_cast<const char*>(data), size);
+}
+const char* HardwareSerial::hostOutput() const { return serial_tx.c_str(); }
+size_t HardwareSerial::hostOutputSize() const { return serial_tx.size(); }
+void HardwareSerial::hostClearOutput() { serial_tx.clear(); }
+void HardwareSerial::hostSetOutputLimit(size_t limit) { serial_tx_limit = limit; }
@@ -0,0 +1,208 @@
+/*
+    Host stand-in of the Arduino core, just enough to build and run firmware sources on a PC.
+    Time is virtual: it only moves when the test advances it, when delay() is called,
+    or by a small cost on every micros() / millis() call, so busy-wait loops end.
+    micros() and millis() are 32 bits wide as on AVR and wrap after about 71.6 minutes and 49.7 days.
+    Pin levels and ADC values live in Hal::Host::state() of hal_host_state.h, shared with the HAL host backend.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define DEFAULT 1
+#define INTERNAL 3
+
+#if defined(ARDUINO_ARCH_RP2040)
+#define A0 26
+#define A1 27
+#define A2 28
+#define A3 29
+#else
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#endif
+
+#define bit(b) (1UL << (b))
+#define bitRead(value, b) (((value) >> (b)) & 0x01)
+#define bitSet(value, b) ((value) |= (1UL << (b)))
+#define bitClear(value, b) ((value) &= ~(1UL << (b)))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Functions instead of the AVR core macros, so standard library headers stay usable
+template <typename A, typename B>
+inline auto min(A a, B b) { return a < b ? a : b; }
+template <typename A, typename B>
+inline auto max(A a, B b) { return a > b ? a : b; }
+
+uint32_t millis();
+uint32_t micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+int analogRead(uint8_t pin);
+void analogReference(uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+void pinMode(uint8_t pin, uint8_t mode);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+void noInterrupts();
+void interrupts();
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+// Heap backed string with Arduino semantics: copies reuse the buffer when it is large enough.
+// Allocations are counted, so tests can check that a code path does not touch the heap.
+class String
+{
+public:
+    String(const char* value = "");
+    String(const String& other);
+    String(String&& other) noexcept;
+    explicit String(char value);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    ~String();
+
+    String& operator=(const String& other);
+    String& operator=(String&& other) noexcept;
+    String& operator=(const char* value);
+
+    unsigned char reserve(unsigned int size);
+    unsigned int length() const { return length_; }
+    const char* c_str() const { return buffer_ != nullptr ? buffer_ : ""; }
+    char operator[](unsigned int index) const;
+    bool operator==(const String& other) const;
+    bool operator==(const char* other) const;
+    bool operator!=(const String& other) const { return !(*this == other); }
+
+    String& concat(const char* value, unsigned int length);
+    String& operator+=(const String& value) { return concat(value.c_str(), value.length()); }
+    String& operator+=(const char* value) { return concat(value, strlen(value)); }
+    String& operator+=(char value) { return concat(&value, 1); }
+    String& operator+=(int value);
+    String& operator+=(unsigned int value);
+    String& operator+=(long value);
+    String& operator+=(unsigned long value);
+
+private:
+    void assign(const char* value, unsigned int length);
+
+    char* buffer_;
+    unsigned int capacity_;
+    unsigned int length_;
+};
+
+class Print
+{
+public:
+    virtual ~Print() = default;
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* buffer, size_t size) { return write(reinterpret_cast<const uint8_t*>(buffer), size); }
+    size_t write(const char* text) { return text != nullptr ? write(text, strlen(text)) : 0; }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const __FlashStringHelper* text);
+    size_t print(const String& text);
+    size_t print(const char* text);
+    size_t print(char value);
+    size_t print(unsigned char value, int base = 10);
+    size_t print(int value, int base = 10);
+    size_t print(unsigned int value, int base = 10);
+    size_t print(long value, int base = 10);
+    size_t print(unsigned long value, int base = 10);
+    size_t print(double value, int digits = 2);
+
+    size_t println();
+    template <typename T>
+    size_t println(const T& value) { const size_t n = print(value); return n + println(); }
+    template <typename T>
+    size_t println(const T& value, int format) { const size_t n = print(value, format); return n + println(); }
+
+private:
+    size_t printNumber(unsigned long value, int base);
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+// Serial port: test writes bytes the firmware reads, firmware output is collected in a buffer
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long baud);
+    void end();
+    explicit operator bool() const { return is_open_; }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t value) override;
+    using Print::write;
+    int availableForWrite() override { return kTxBufferSize - 1; }
+
+    // Host side of the port
+    void hostWrite(const char* text);
+    void hostWrite(const uint8_t* data, size_t size);
+    const char* hostOutput() const;
+    size_t hostOutputSize() const;
+    void hostClearOutput();
+    // Output beyond this limit is counted but not kept, long runs do not grow memory
+    void hostSetOutputLimit(size_t limit);
+    unsigned long hostBytesWritten() const { return bytes_written_; }
+    unsigned long hostBaud() const { return baud_; }
+
+private:
+    static constexpr int kTxBufferSize = 64;    // AVR core TX buffer
+
+    bool is_open_ = false;
+    unsigned long baud_ = 0;
+    unsigned long bytes_written_ = 0;
+};
+
+extern HardwareSerial Serial;
+
+namespace ArduinoHost
+{
+// Virtual clock, starts at 0 after reset(). Clock keeps 64 bits, so millis() wraps at 2^32 ms
+// independently of micros(), set it with full width to start near either wrap.
+void reset();
+void setMicros(uint64_t now_us);
+void advanceMicros(uint32_t delta_us);
+// micros() without call cost
+uint32_t peekMicros();
+// Cost of one micros() / millis() call, 0 freezes time between explicit advances
+void setCallCostUs(unsigned long cost_us);
+
+// Live String heap buffers and total allocations since reset()
+unsigned long stringLiveAllocations();
+unsigned long stringTotalAllocations();
+}   // namespace ArduinoHost
@@ -0,0 +1,75 @@
+#include <ArduinoLog.h>
+
+Logging Log;
+
+void Logging::begin(int level, Print* output, bool show_level) {
+    level_ = level;
+    output_ = output;
+    show_level_ = show_level;
+}
+
+void Logging::print(int level, const char* format, const Arg* args, size_t count) {
+    static const char kLevelChars[] = "SFEWNTV";
+    message_count_++;
+    if (show_level_) {
+        output_->print(kLevelChars[level]);
+        output_->print(": ");
+    }
+    size_t next = 0;
+    for (const char* cursor = format; *cursor != '\0'; cursor++) {
+        if (*cursor != '%' || cursor[1] == '\0') {
+            output_->print(*cursor);
+            continue;
+        }
+        const char specifier = *++cursor;
+        if (specifier == '%') {
+            output_->print('%');
+            continue;
+        }
+        if (next >= count) {
+            output_->print('%');
+            output_->print(specifier);
+            continue;
+        }
+        const Arg& arg = args[next++];
+        char text[32];
+        switch (specifier) {
+            case 'd':
+            case 'i':
+            case 'l':
+            case 'u':
+                if (arg.kind == Arg::kFloat) {
+                    snprintf(text, sizeof(text), "%g", arg.real);
+                } else if (arg.kind == Arg::kUnsigned) {
+                    snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(arg.integer));
+                } else {
+                    snprintf(text, sizeof(text), "%lld", arg.integer);
+                }
+                output_->print(text);
+                break;
+            case 'x':
+            case 'X':
+                snprintf(text, sizeof(text), specifier == 'x' ? "0x%llx" : "0x%llX",
+                         static_cast<unsigned long long>(arg.integer));
+                output_->print(text);
+                break;
+            case 'c':
+                output_->print(static_cast<char>(arg.integer));
+                break;
+            case 's':
+            case 'S':
+                output_->print(arg.text != nullptr ? arg.text : "(null)");
+                break;
+            case 'D':
+            case 'F':
+                snprintf(text, sizeof(text), "%g", arg.real);
+                output_->print(text);
+                break;
+            default:
+                output_->print('%');
+                output_->print(specifier);
+                break;
+        }
+    }
+    output_->println();
+}
@@ -0,0 +1,73 @@
+/*
+    Host stand-in of thijse/ArduinoLog. Supports the format specifiers used by firmware:
+    %d %l %u %x %c %s, unknown specifiers are printed as is.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+#include <type_traits>
+
+#define LOG_LEVEL_SILENT 0
+#define LOG_LEVEL_FATAL 1
+#define LOG_LEVEL_ERROR 2
+#define LOG_LEVEL_WARNING 3
+#define LOG_LEVEL_NOTICE 4
+#define LOG_LEVEL_INFO 4
+#define LOG_LEVEL_TRACE 5
+#define LOG_LEVEL_VERBOSE 6
+
+class Logging
+{
+public:
+    void begin(int level, Print* output, bool show_level = true);
+    void setLevel(int level) { level_ = level; }
+    int getLevel() const { return level_; }
+
+    template <class T, class... Args> void fatalln(T msg, Args... args) { printLevel(LOG_LEVEL_FATAL, msg, args...); }
+    template <class T, class... Args> void errorln(T msg, Args... args) { printLevel(LOG_LEVEL_ERROR, msg, args...); }
+    template <class T, class... Args> void warningln(T msg, Args... args) { printLevel(LOG_LEVEL_WARNING, msg, args...); }
+    template <class T, class... Args> void noticeln(T msg, Args... args) { printLevel(LOG_LEVEL_NOTICE, msg, args...); }
+    template <class T, class... Args> void infoln(T msg, Args... args) { printLevel(LOG_LEVEL_INFO, msg, args...); }
+    template <class T, class... Args> void traceln(T msg, Args... args) { printLevel(LOG_LEVEL_TRACE, msg, args...); }
+    template <class T, class... Args> void verboseln(T msg, Args... args) { printLevel(LOG_LEVEL_VERBOSE, msg, args...); }
+
+    // Number of messages that passed the level filter, printed or not
+    unsigned long hostMessageCount() const { return message_count_; }
+
+private:
+    struct Arg {
+        enum Kind { kInteger, kUnsigned, kFloat, kText } kind;
+        long long integer;
+        double real;
+        const char* text;
+
+        template <typename V, typename std::enable_if<std::is_integral<V>::value || std::is_enum<V>::value, int>::type = 0>
+        Arg(V value): kind(std::is_signed<V>::value ? kInteger : kUnsigned),
+                      integer(static_cast<long long>(value)), real(0), text(nullptr) {}
+        template <typename V, typename std::enable_if<std::is_floating_point<V>::value, int>::type = 0>
+        Arg(V value): kind(kFloat), integer(0), real(value), text(nullptr) {}
+        Arg(const char* value): kind(kText), integer(0), real(0), text(value) {}
+        Arg(const __FlashStringHelper* value):
+            kind(kText), integer(0), real(0), text(reinterpret_cast<const char*>(value)) {}
+        Arg(const String& value): kind(kText), integer(0), real(0), text(value.c_str()) {}
+    };
+
+    template <class T, class... Args>
+    void printLevel(int level, T msg, Args... args) {
+        if (level > level_ || output_ == nullptr) {
+            return;
+        }
+        const Arg arg_list[] = {Arg(args)..., Arg(0)};
+        print(level, reinterpret_cast<const char*>(msg), arg_list, sizeof...(Args));
+    }
+
+    void print(int level, const char* format, const Arg* args, size_t count);
+
+    int level_ = LOG_LEVEL_SILENT;
+    Print* output_ = nullptr;
+    bool show_level_ = true;
+    unsigned long message_count_ = 0;
+};
+
+extern Logging Log;
@@ -0,0 +1,56 @@
+/*
+    Host stand-in of the Arduino EEPROM library, 1 KiB erased to 0xFF like a new ATmega328P.
+    begin() and commit() of flash emulating cores (RP2040, ESP) are accepted too.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+class EEPROMClass
+{
+public:
+    static constexpr uint16_t kSize = 1024;
+
+    EEPROMClass() { hostErase(); }
+
+    void begin(size_t size) { begin_size_ = size; }
+    bool commit() { ++commit_count_; return begin_size_ > 0; }
+    uint8_t read(int address) const { return data_[address % kSize]; }
+    void write(int address, uint8_t value) { data_[address % kSize] = value; ++write_count_; }
+    void update(int address, uint8_t value) {
+        if (read(address) != value) {
+            write(address, value);
+        }
+    }
+    uint16_t length() const { return kSize; }
+
+    template <typename T>
+    T& get(int address, T& value) const {
+        memcpy(&value, &data_[address], sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    const T& put(int address, const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            update(address + static_cast<int>(i), bytes[i]);
+        }
+        return value;
+    }
+
+    // Host side
+    void hostErase() { memset(data_, 0xFF, sizeof(data_)); write_count_ = 0; commit_count_ = 0; }
+    unsigned long hostWriteCount() const { return write_count_; }
+    unsigned long hostCommitCount() const { return commit_count_; }
+    size_t hostBeginSize() const { return begin_size_; }
+
+private:
+    uint8_t data_[kSize];
+    unsigned long write_count_ = 0;
+    unsigned long commit_count_ = 0;
+    size_t begin_size_ = 0;     // commit fails without begin, like on flash emulating cores
+};
+
+extern EEPROMClass EEPROM;
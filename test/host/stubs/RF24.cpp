@@ -0,0 +1,245 @@
+#include <RF24.h>
+
+namespace
+{
+RF24* radios = nullptr;
+RF24Host::LossHook loss_hook;
+RF24Host::Stats air_stats = {};
+bool begin_result = true;
+
+constexpr unsigned long kSettleUs = 130;        // PLL settling before every transmission
+constexpr unsigned long kPowerUpUs = 5000;      // RF24 library delay in powerUp()
+constexpr uint8_t kOverheadBytes = 9;           // preamble, address, packet control field and CRC
+}   // namespace
+
+namespace RF24Host
+{
+void reset() {
+    loss_hook = nullptr;
+    air_stats = Stats{};
+    begin_result = true;
+}
+
+void setLossHook(LossHook hook) { loss_hook = hook; }
+void setBeginResult(bool result) { begin_result = result; }
+const Stats& stats() { return air_stats; }
+}   // namespace RF24Host
+
+RF24::RF24(uint16_t ce_pin, uint16_t csn_pin): ce_pin_(ce_pin), csn_pin_(csn_pin), next_(radios) {
+    radios = this;
+}
+
+RF24::~RF24() {
+    for (RF24** link = &radios; *link != nullptr; link = &(*link)->next_) {
+        if (*link == this) {
+            *link = next_;
+            break;
+        }
+    }
+}
+
+bool RF24::begin() {
+    is_begun_ = begin_result;
+    if (!is_begun_) {
+        return false;
+    }
+    is_powered_down_ = false;
+    is_listening_ = false;
+    channel_ = 76;
+    data_rate_ = RF24_1MBPS;
+    retry_delay_ = 5;
+    retry_count_ = 15;
+    rx_count_ = 0;
+    ack_count_ = 0;
+    return true;
+}
+
+void RF24::setPALevel(uint8_t level, bool) {
+    pa_level_ = level > RF24_PA_MAX ? RF24_PA_MAX : level;
+}
+
+void RF24::setRetries(uint8_t delay, uint8_t count) {
+    retry_delay_ = delay & 0x0F;
+    retry_count_ = count & 0x0F;
+}
+
+void RF24::openWritingPipe(const uint8_t* address) {
+    memcpy(tx_address_, address, kAddressSize);
+}
+
+void RF24::openReadingPipe(uint8_t pipe, const uint8_t* address) {
+    if (pipe >= kPipeCount) {
+        return;
+    }
+    // Pipes 2..5 only have own first byte, like the chip registers
+    memcpy(rx_address_[pipe], address, pipe < 2 ? kAddressSize : 1);
+    rx_enabled_[pipe] = true;
+}
+
+void RF24::startListening() {
+    if (ack_payloads_) {
+        ack_count_ = 0;     // RF24 library flushes TX FIFO here
+    }
+    is_listening_ = true;
+}
+
+void RF24::stopListening() {
+    if (ack_payloads_) {
+        ack_count_ = 0;
+    }
+    is_listening_ = false;
+}
+
+void RF24::powerDown() {
+    is_powered_down_ = true;
+    is_listening_ = false;
+}
+
+void RF24::powerUp() {
+    if (is_powered_down_) {
+        ArduinoHost::advanceMicros(kPowerUpUs);
+        is_powered_down_ = false;
+    }
+}
+
+bool RF24::write(const void* buffer, uint8_t length, const bool multicast) {
+    arc_ = 0;
+    if (!is_begun_ || is_powered_down_ || is_listening_) {
+        return false;
+    }
+    length = length > kMaxPayload ? kMaxPayload : length;
+    const bool expects_ack = auto_ack_ && !multicast;
+    const uint8_t attempts = expects_ack ? retry_count_ + 1 : 1;
+    const uint8_t* data = static_cast<const uint8_t*>(buffer);
+
+    for (uint8_t attempt = 0; attempt < attempts; ++attempt) {
+        ArduinoHost::advanceMicros(airTimeUs(length));
+        ++air_stats.attempts;
+        RF24* acknowledger = nullptr;
+        uint8_t acknowledged_pipe = 0;
+        if (loss_hook && loss_hook(*this, data, length, attempt)) {
+            ++air_stats.lost;
+        } else {
+            for (RF24* radio = radios; radio != nullptr; radio = radio->next_) {
+                if (radio == this || !radio->is_begun_ || radio->is_powered_down_ ||
+                    !radio->is_listening_ || radio->channel_ != channel_) {
+                    continue;
+                }
+                const uint8_t pipe = radio->matchPipe(tx_address_);
+                if (pipe >= kPipeCount) {
+                    continue;
+                }
+                if (!radio->pushRx(pipe, data, length)) {
+                    ++air_stats.fifo_full;
+                    continue;
+                }
+                ++air_stats.delivered;
+                if (acknowledger == nullptr) {
+                    acknowledger = radio;
+                    acknowledged_pipe = pipe;
+                }
+            }
+        }
+        if (!expects_ack) {
+            return true;    // TX_DS is set as soon as the packet left
+        }
+        if (acknowledger != nullptr) {
+            Payload ack;
+            const bool has_payload = acknowledger->popAck(acknowledged_pipe, ack);
+            ArduinoHost::advanceMicros(airTimeUs(has_payload ? ack.length : 0));
+            if (has_payload) {
+                pushRx(0, ack.data, ack.length);
+            }
+            return true;
+        }
+        if (attempt + 1 < attempts) {
+            ++arc_;
+            ArduinoHost::advanceMicros((retry_delay_ + 1UL) * 250UL);
+        }
+    }
+    return false;
+}
+
+bool RF24::available(uint8_t* pipe) {
+    if (rx_count_ == 0) {
+        return false;
+    }
+    if (pipe != nullptr) {
+        *pipe = rx_fifo_[0].pipe;
+    }
+    return true;
+}
+
+uint8_t RF24::getDynamicPayloadSize() {
+    return rx_count_ > 0 ? rx_fifo_[0].length : 0;
+}
+
+void RF24::read(void* buffer, uint8_t length) {
+    if (rx_count_ == 0) {
+        return;
+    }
+    memcpy(buffer, rx_fifo_[0].data, length < rx_fifo_[0].length ? length : rx_fifo_[0].length);
+    memmove(&rx_fifo_[0], &rx_fifo_[1], sizeof(Payload) * (rx_count_ - 1));
+    --rx_count_;
+}
+
+void RF24::writeAckPayload(uint8_t pipe, const void* buffer, uint8_t length) {
+    if (ack_count_ >= kFifoSize) {
+        return;
+    }
+    Payload& payload = ack_fifo_[ack_count_++];
+    payload.pipe = pipe;
+    payload.length = length > kMaxPayload ? kMaxPayload : length;
+    memcpy(payload.data, buffer, payload.length);
+}
+
+uint8_t RF24::matchPipe(const uint8_t* address) const {
+    for (uint8_t pipe = 0; pipe < kPipeCount; ++pipe) {
+        if (!rx_enabled_[pipe]) {
+            continue;
+        }
+        const bool match = pipe < 2 ?
+            memcmp(rx_address_[pipe], address, kAddressSize) == 0 :
+            rx_address_[pipe][0] == address[0] && memcmp(rx_address_[1] + 1, address + 1, kAddressSize - 1) == 0;
+        if (match) {
+            return pipe;
+        }
+    }
+    return kPipeCount;
+}
+
+bool RF24::pushRx(uint8_t pipe, const void* data, uint8_t length) {
+    if (rx_count_ >= kFifoSize) {
+        return false;
+    }
+    Payload& payload = rx_fifo_[rx_count_++];
+    payload.pipe = pipe;
+    payload.length = length;
+    memcpy(payload.data, data, length);
+    return true;
+}
+
+bool RF24::popAck(uint8_t pipe, Payload& payload) {
+    for (uint8_t i = 0; i < ack_count_; ++i) {
+        if (ack_fifo_[i].pipe != pipe) {
+            continue;
+        }
+        payload = ack_fifo_[i];
+        memmove(&ack_fifo_[i], &ack_fifo_[i + 1], sizeof(Payload) * (ack_count_ - i - 1));
+        --ack_count_;
+        return true;
+    }
+    return false;
+}
+
+unsigned long RF24::airTimeUs(uint8_t length) const {
+    const unsigned long bits = (kOverheadBytes + length) * 8UL;
+    switch (data_rate_) {
+        case RF24_2MBPS:
+            return kSettleUs + bits / 2;
+        case RF24_250KBPS:
+            return kSettleUs + bits * 4;
+        default:
+            return kSettleUs + bits;
+    }
+}
@@ -0,0 +1,121 @@
+/*
+    Host stand-in of nrf24/RF24 that simulates the air between all RF24 objects of the program.
+    A write reaches every powered, listening radio on the same channel with a matching pipe address.
+    Enhanced ShockBurst is modelled: retransmissions with getARC(), ACK payloads into the sender
+    RX FIFO, 3 level RX FIFO without ACK when full, and NO_ACK writes with the multicast flag.
+    Air time of every attempt advances the virtual clock of the Arduino stand-in.
+*/
+#pragma once
+
+#include <Arduino.h>
+
+#include <functional>
+
+typedef enum { RF24_PA_MIN = 0, RF24_PA_LOW, RF24_PA_HIGH, RF24_PA_MAX, RF24_PA_ERROR } rf24_pa_dbm_e;
+typedef enum { RF24_1MBPS = 0, RF24_2MBPS, RF24_250KBPS } rf24_datarate_e;
+
+class RF24
+{
+public:
+    static constexpr uint8_t kPipeCount = 6;
+    static constexpr uint8_t kFifoSize = 3;
+    static constexpr uint8_t kMaxPayload = 32;
+    static constexpr uint8_t kAddressSize = 5;
+
+    RF24(uint16_t ce_pin, uint16_t csn_pin);
+    ~RF24();
+    RF24(const RF24&) = delete;
+    RF24& operator=(const RF24&) = delete;
+
+    bool begin();
+    bool isChipConnected() { return is_begun_; }
+    void setPALevel(uint8_t level, bool lna_enable = true);
+    uint8_t getPALevel() { return pa_level_; }
+    void setDataRate(rf24_datarate_e rate) { data_rate_ = rate; }
+    void setChannel(uint8_t channel) { channel_ = channel; }
+    uint8_t getChannel() { return channel_; }
+    void setRetries(uint8_t delay, uint8_t count);
+    void enableDynamicPayloads() {}
+    void enableAckPayload() { ack_payloads_ = true; }
+    void enableDynamicAck() {}
+    void setAutoAck(bool enable) { auto_ack_ = enable; }
+
+    void openWritingPipe(const uint8_t* address);
+    void openReadingPipe(uint8_t pipe, const uint8_t* address);
+    void startListening();
+    void stopListening();
+    void powerDown();
+    void powerUp();
+
+    bool write(const void* buffer, uint8_t length) { return write(buffer, length, false); }
+    bool write(const void* buffer, uint8_t length, const bool multicast);
+    bool available() { return rx_count_ > 0; }
+    bool available(uint8_t* pipe);
+    uint8_t getDynamicPayloadSize();
+    void read(void* buffer, uint8_t length);
+    void writeAckPayload(uint8_t pipe, const void* buffer, uint8_t length);
+    uint8_t getARC() { return arc_; }
+    void flush_rx() { rx_count_ = 0; }
+    void flush_tx() { ack_count_ = 0; }
+
+    // Host side
+    uint16_t hostCePin() const { return ce_pin_; }
+    bool hostIsListening() const { return is_listening_; }
+    bool hostIsPoweredDown() const { return is_powered_down_; }
+    uint8_t hostRxCount() const { return rx_count_; }
+
+private:
+    struct Payload {
+        uint8_t pipe;
+        uint8_t length;
+        uint8_t data[kMaxPayload];
+    };
+
+    // @return pipe with matching address or kPipeCount
+    uint8_t matchPipe(const uint8_t* address) const;
+    bool pushRx(uint8_t pipe, const void* data, uint8_t length);
+    bool popAck(uint8_t pipe, Payload& payload);
+    unsigned long airTimeUs(uint8_t length) const;
+
+    uint16_t ce_pin_;
+    uint16_t csn_pin_;
+    bool is_begun_ = false;
+    bool is_listening_ = false;
+    bool is_powered_down_ = true;
+    bool auto_ack_ = true;
+    bool ack_payloads_ = false;
+    uint8_t pa_level_ = RF24_PA_MAX;
+    rf24_datarate_e data_rate_ = RF24_1MBPS;
+    uint8_t channel_ = 76;
+    uint8_t retry_delay_ = 5;
+    uint8_t retry_count_ = 15;
+    uint8_t arc_ = 0;
+    uint8_t tx_address_[kAddressSize] = {};
+    uint8_t rx_address_[kPipeCount][kAddressSize] = {};
+    bool rx_enabled_[kPipeCount] = {};
+    Payload rx_fifo_[kFifoSize];
+    uint8_t rx_count_ = 0;
+    Payload ack_fifo_[kFifoSize];
+    uint8_t ack_count_ = 0;
+    RF24* next_ = nullptr;
+};
+
+namespace RF24Host
+{
+// Decides for every transmission attempt whether it is lost on air, attempt counts from 0
+using LossHook = std::function<bool(const RF24& sender, const uint8_t* data, uint8_t length, uint8_t attempt)>;
+
+struct Stats {
+    unsigned long attempts;     // transmission attempts, retransmissions included
+    unsigned long lost;         // attempts dropped by loss hook
+    unsigned long delivered;    // payloads placed into a receiver FIFO
+    unsigned long fifo_full;    // attempts not acknowledged because receiver FIFO was full
+};
+
+// Remove loss hook, clear stats and let begin() succeed
+void reset();
+void setLossHook(LossHook hook);
+// Next begin() calls return result, e.g. to simulate missing module
+void setBeginResult(bool result);
+const Stats& stats();
+}   // namespace RF24Host
@@ -0,0 +1,206 @@
+/*
+    BluetoothTransmitter link setup and PID batch acknowledge against the Serial stand-in.
+*/
+#include "test_support.h"
+#include "bluetooth_transmitter.h"
+
+#include <string>
+
+namespace
+{
+// Run module setup until robot heartbeat was seen
+void connect(BluetoothTransmitter& bluetooth) {
+    CHECK(bluetooth.Initialize());
+    Serial.hostWrite("OK");     // AT+BAUD3
+    bluetooth.Update();
+    Serial.hostWrite("OK");     // AT at target baud rate
+    bluetooth.Update();
+    CHECK(bluetooth.IsBaudConfirmed());
+    Serial.hostWrite("H*");
+    bluetooth.Update();
+    CHECK(bluetooth.IsConnected());
+    Serial.hostClearOutput();
+}
+
+size_t countOccurrences(const std::string& text, const char* pattern) {
+    size_t count = 0;
+    for (size_t position = text.find(pattern); position != std::string::npos;
+         position = text.find(pattern, position + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+// Run Update until link state changes or time runs out
+void updateFor(BluetoothTransmitter& bluetooth, unsigned long duration_ms) {
+    const unsigned long end_us = ArduinoHost::peekMicros() + duration_ms * 1000UL;
+    while (ArduinoHost::peekMicros() < end_us) {
+        bluetooth.Update();
+        ArduinoHost::advanceMicros(10000);
+    }
+}
+
+// Sequence number of last batch frame written to serial
+std::string lastBatchSequence() {
+    const std::string output = Serial.hostOutput();
+    const size_t start = output.rfind('P');
+    return start == std::string::npos ? std::string() : output.substr(start + 1, 2);
+}
+
+void testBatchFrameFormat() {
+    HostTest::resetWorld();
+    BluetoothTransmitter bluetooth(&Serial);
+    connect(bluetooth);
+
+    const PidParameter params[] = {
+        {CommandType::kPidSetting1, 0x0180},
+        {CommandType::kPidSetting2, -256},
+    };
+    CHECK(bluetooth.SendPidBatch(params, 2));
+    CHECK(bluetooth.GetPidBatchState() == PidBatchState::kPending);
+    const std::string frame = Serial.hostOutput();
+    CHECK_EQ(frame.size(), 1 + 2 + 2 * 5 + 2 + 1);
+    CHECK(frame.compare(0, 13, "P01C0180DFF00") == 0);
+    CHECK_EQ(frame.back(), '*');
+    uint8_t checksum = 0;
+    for (size_t i = 0; i < frame.size() - 3; ++i) {
+        checksum ^= static_cast<uint8_t>(frame[i]);
+    }
+    CHECK_EQ(strtol(frame.substr(frame.size() - 3, 2).c_str(), nullptr, 16), checksum);
+
+    // Second batch is rejected while first one is pending
+    CHECK(!bluetooth.SendPidBatch(params, 1));
+    Serial.hostWrite("KP01*");
+    bluetooth.Update();
+    CHECK(bluetooth.GetPidBatchState() == PidBatchState::kAcked);
+}
+
+// Late acknowledge of a retried batch must not acknowledge the next one
+void testLateAckIsIgnored() {
+    HostTest::resetWorld();
+    BluetoothTransmitter bluetooth(&Serial);
+    connect(bluetooth);
+
+    const PidParameter first[] = {{CommandType::kPidSetting1, 100}};
+    CHECK(bluetooth.SendPidBatch(first, 1));
+    const std::string first_sequence = lastBatchSequence();
+    // No acknowledge, batch is retried and finally fails
+    for (int i = 0; i < 5; ++i) {
+        ArduinoHost::advanceMicros(250000);
+        Serial.hostWrite("H*");
+        bluetooth.Update();
+    }
+    CHECK(bluetooth.GetPidBatchState() == PidBatchState::kFailed);
+
+    const PidParameter second[] = {{CommandType::kPidSetting1, 200}};
+    Serial.hostClearOutput();
+    CHECK(bluetooth.SendPidBatch(second, 1));
+    const std::string second_sequence = lastBatchSequence();
+    CHECK(first_sequence != second_sequence);
+
+    // Acknowledges of the retries of the first batch arrive now
+    const std::string stale_ack = "KP" + first_sequence + "*";
+    Serial.hostWrite(stale_ack.c_str());
+    Serial.hostWrite("KP*");
+    bluetooth.Update();
+    CHECK(bluetooth.GetPidBatchState() == PidBatchState::kPending);
+
+    const std::string ack = "KP" + second_sequence + "*";
+    Serial.hostWrite(ack.c_str());
+    bluetooth.Update();
+    CHECK(bluetooth.GetPidBatchState() == PidBatchState::kAcked);
+}
+
+// Speed commands go out every frame, they are formatted without heap allocation
+void testPadCommandWithoutHeap() {
+    HostTest::resetWorld();
+    BluetoothTransmitter bluetooth(&Serial);
+    connect(bluetooth);
+    CHECK(strcmp(bluetooth.GetLastCommand(), "") == 0);
+
+    const unsigned long allocations = ArduinoHost::stringTotalAllocations();
+    CHECK(bluetooth.SendSpeedCommand(-127, 5));
+    CHECK(strcmp(Serial.hostOutput(), "SX-127Y5*") == 0);
+    CHECK(strcmp(bluetooth.GetLastCommand(), "SX-127Y5*") == 0);
+    Serial.hostClearOutput();
+    CHECK(bluetooth.SendRotationCommand(0, 127));
+    CHECK(strcmp(Serial.hostOutput(), "RX0Y127*") == 0);
+    CHECK(!bluetooth.SendSpeedCommand(128, 0));
+    CHECK(strcmp(bluetooth.GetLastCommand(), "RX0Y127*") == 0);
+
+    BP32Data::PackedControllerData frame = {};
+    for (int32_t axis = -512; axis <= 512; axis += 8) {
+        frame.axis_x = axis;
+        frame.axis_y = -axis;
+        Serial.hostClearOutput();
+        CHECK(bluetooth.sendFrame(frame));
+    }
+    CHECK(strcmp(bluetooth.GetLastCommand(), "SX127Y-127*") == 0);
+    CHECK_EQ(ArduinoHost::stringTotalAllocations(), allocations);
+}
+}   // namespace
+
+// Silent module: baud change is retried at default rate, target rate is only trusted once
+// a robot message was parsed there, otherwise setup starts over
+void testBaudSetupRetries() {
+    HostTest::resetWorld();
+    BluetoothTransmitter bluetooth(&Serial);
+    CHECK(bluetooth.Initialize());
+    CHECK_EQ(Serial.hostBaud(), 9600);
+
+    updateFor(bluetooth, 3 * 2 * 300 + 50);
+    CHECK_EQ(countOccurrences(Serial.hostOutput(), "AT+BAUD3"), 3);
+    CHECK(bluetooth.GetLinkState() == BleLinkState::kDisconnected);
+    CHECK(!bluetooth.IsBaudConfirmed());
+    CHECK_EQ(Serial.hostBaud(), 38400);
+
+    // Unknown message may be noise at wrong baud rate, it does not confirm anything
+    Serial.hostWrite("X*");
+    bluetooth.Update();
+    CHECK(!bluetooth.IsConnected());
+    CHECK(!bluetooth.IsBaudConfirmed());
+
+    // Without robot message setup starts over at default baud rate
+    Serial.hostClearOutput();
+    updateFor(bluetooth, 3000);
+    CHECK(bluetooth.GetLinkState() == BleLinkState::kSettingBaud);
+    CHECK_EQ(Serial.hostBaud(), 9600);
+    CHECK_EQ(countOccurrences(Serial.hostOutput(), "AT+BAUD3"), 1);
+
+    // Module finally answers, link comes up at target baud rate
+    Serial.hostWrite("OK");
+    bluetooth.Update();
+    Serial.hostWrite("OK");
+    bluetooth.Update();
+    CHECK(bluetooth.IsBaudConfirmed());
+    Serial.hostWrite("H*");
+    bluetooth.Update();
+    CHECK(bluetooth.IsConnected());
+}
+
+// Paired module ignores AT commands, heartbeat at target baud rate confirms it
+void testHeartbeatConfirmsBaud() {
+    HostTest::resetWorld();
+    BluetoothTransmitter bluetooth(&Serial);
+    CHECK(bluetooth.Initialize());
+    updateFor(bluetooth, 3 * 2 * 300 + 50);
+    CHECK(bluetooth.GetLinkState() == BleLinkState::kDisconnected);
+    Serial.hostWrite("H*");
+    bluetooth.Update();
+    CHECK(bluetooth.IsBaudConfirmed());
+    CHECK(bluetooth.IsConnected());
+
+    // Confirmed rate is kept when heartbeat is lost
+    updateFor(bluetooth, 5000);
+    CHECK(bluetooth.GetLinkState() == BleLinkState::kDisconnected);
+    CHECK_EQ(Serial.hostBaud(), 38400);
+}
+
+int main() {
+    testBatchFrameFormat();
+    testLateAckIsIgnored();
+    testPadCommandWithoutHeap();
+    testBaudSetupRetries();
+    testHeartbeatConfirmsBaud();
+    return HostTest::finish("test_bluetooth_transmitter");
+}
@@ -0,0 +1,152 @@
+/*
+    Input capture stream as produced with the serial console, and its replay
+    through the controller pipeline and the nRF24 link.
+*/
+#include "test_support.h"
+#include "capture_replay.h"
+#include "command_console.h"
+
+#include <string>
+
+namespace
+{
+InputCapture* active_capture = nullptr;
+CommandConsole* active_console = nullptr;
+
+// Same behavior as setInputCapture of main.cpp
+bool setParam(void*, ConsoleParam param, int32_t value) {
+    if (param != ConsoleParam::kCapture || (value != 0 && value != 1)) {
+        return false;
+    }
+    active_console->SetMuted(value == 1);
+    if (value == 1) {
+        active_capture->Start();
+    } else {
+        active_capture->Stop();
+    }
+    return true;
+}
+
+bool getParam(void*, ConsoleParam param, int32_t* value) {
+    *value = param == ConsoleParam::kCapture && active_capture->IsActive() ? 1 : 0;
+    return param == ConsoleParam::kCapture;
+}
+
+void dumpStats(void*, Print* out) {
+    out->println("uptime_ms 0");
+}
+
+constexpr unsigned int kRecordCount = 300;
+constexpr uint32_t kTickUs = 10000;
+
+// Scripted session: stick sweeps right, button A is held for 100 ms with contact bounce
+CaptureRecord scriptedRecord(unsigned int tick) {
+    CaptureRecord record;
+    record.time_us = 1000000UL + tick * kTickUs;
+    record.x_raw = static_cast<uint16_t>(tick < 200 ? 512 + tick * 2 : 912);
+    record.y_raw = 512;
+    record.buttons = (tick >= 100 && tick < 110) ? ButtonMask::kButtonA : 0;
+    if (tick == 101 || tick == 103) {
+        record.buttons = 0;     // bounce
+    }
+    return record;
+}
+
+// Capture with console commands arriving while records stream
+std::string recordSession() {
+    InputCapture capture(&Serial);
+    CommandConsole console(&Serial, ConsoleHandlers{getParam, setParam, dumpStats, nullptr, nullptr, nullptr});
+    active_capture = &capture;
+    active_console = &console;
+
+    Serial.hostWrite("set cap 1\n");
+    console.Poll();
+    for (unsigned int tick = 0; tick < kRecordCount; ++tick) {
+        if (tick == 50) {
+            Serial.hostWrite("get cap\n");
+        } else if (tick == 60) {
+            Serial.hostWrite("stats\n");
+        } else if (tick == 70) {
+            Serial.hostWrite("bogus\n");
+        } else if (tick == 80) {
+            const uint8_t frame[] = {0xA5, 'G', static_cast<uint8_t>(ConsoleParam::kCapture), 0, 0,
+                                     static_cast<uint8_t>('G' ^ static_cast<uint8_t>(ConsoleParam::kCapture))};
+            Serial.hostWrite(frame, sizeof(frame));
+        }
+        console.Poll();
+        const CaptureRecord record = scriptedRecord(tick);
+        JoystickData joystick = {};
+        joystick.x_raw = record.x_raw;
+        joystick.y_raw = record.y_raw;
+        CHECK(capture.Write(record.time_us, joystick, record.buttons));
+    }
+    Serial.hostWrite("set cap 0\n");
+    console.Poll();
+    // Console talks again after capture
+    Serial.hostWrite("get cap\n");
+    console.Poll();
+    return std::string(Serial.hostOutput(), Serial.hostOutputSize());
+}
+
+void testConsoleIsSilentDuringCapture(const std::string& stream) {
+    const std::string start_reply = "OK cap 1\r\n";
+    const std::string stop_reply = "OK cap 0\r\nOK cap 0\r\n";
+    const size_t records_size = kRecordCount * InputCapture::kRecordSize;
+    CHECK_EQ(stream.size(), start_reply.size() + records_size + stop_reply.size());
+    CHECK(stream.compare(0, start_reply.size(), start_reply) == 0);
+    CHECK(stream.compare(stream.size() - stop_reply.size(), stop_reply.size(), stop_reply) == 0);
+
+    // Records follow each other without any byte in between
+    std::vector<CaptureRecord> records;
+    const auto* bytes = reinterpret_cast<const uint8_t*>(stream.data());
+    CHECK_EQ(CaptureReplay::extractRecords(bytes + start_reply.size(), records_size, &records), 0);
+    CHECK_EQ(records.size(), kRecordCount);
+}
+
+void testReplay(const std::string& stream) {
+    std::vector<CaptureRecord> records;
+    const size_t skipped = CaptureReplay::extractRecords(
+        reinterpret_cast<const uint8_t*>(stream.data()), stream.size(), &records);
+    CHECK_EQ(skipped, stream.size() - kRecordCount * InputCapture::kRecordSize);
+    CHECK_EQ(records.size(), kRecordCount);
+
+    const CalibrationData calibration = {512, 512, 112, 912, 112, 912, true};
+    CaptureReplay::Pipeline pipeline(calibration, InputMapping::ProfileId::kArcade);
+    unsigned int received = 0;
+    unsigned int first_press = 0;
+    unsigned int last_press = 0;
+    for (unsigned int tick = 0; tick < records.size(); ++tick) {
+        const CaptureRecord expected = scriptedRecord(tick);
+        CHECK_EQ(records[tick].time_us, expected.time_us);
+        CHECK_EQ(records[tick].x_raw, expected.x_raw);
+        CHECK_EQ(records[tick].buttons, expected.buttons);
+
+        const CaptureReplay::Frame frame = pipeline.process(records[tick]);
+        CHECK_EQ(frame.joystick.x_raw, expected.x_raw);
+        CHECK_EQ(frame.sent.axis_x, map(expected.x_raw, 512, 912, 0, 512));
+        CHECK_EQ(frame.sent.axis_y, 0);
+        CHECK(frame.is_sent);
+        if (frame.sent.buttons & BP32Data::ControllerButtonConst::kButtonA) {
+            first_press = first_press == 0 ? tick : first_press;
+            last_press = tick;
+        }
+        if (frame.is_received) {
+            ++received;
+            CHECK(memcmp(&frame.received, &frame.sent, sizeof(frame.sent)) == 0);
+        }
+    }
+    // Press is accepted after 4 equal samples past the bounce, release 4 samples after it ends
+    CHECK_EQ(first_press, 107);
+    CHECK_EQ(last_press, 112);
+    CHECK_EQ(received, kRecordCount - (BP32Data::kDefaultFailsafeConfig.recovery_frames - 1));
+    CHECK_EQ(pipeline.controllerLinkStats().frames_failed, 0);
+}
+}   // namespace
+
+int main() {
+    HostTest::resetWorld();
+    const std::string stream = recordSession();
+    testConsoleIsSilentDuringCapture(stream);
+    testReplay(stream);
+    return HostTest::finish("test_capture_replay");
+}
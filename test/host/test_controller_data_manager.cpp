@@ -0,0 +1,198 @@
+/*
+    Change detection of ControllerDataManager: field masks of setControllerData,
+    subscriptions and the neutral frame published by ControllerTable on failsafe entry.
+*/
+#include "test_support.h"
+#include "controller_table.h"
+
+namespace
+{
+using namespace BP32Data::ControllerFieldConst;
+
+// Records every callback, subscription context points to its own recorder
+struct Recorder
+{
+    int calls = 0;
+    uint16_t changed_fields = 0;
+    BP32Data::PackedControllerData data = {};
+
+    static void onChange(void *context, const BP32Data::ControllerDataManager &manager, uint16_t changed_fields) {
+        auto *recorder = static_cast<Recorder*>(context);
+        ++recorder->calls;
+        recorder->changed_fields = changed_fields;
+        recorder->data = manager.controllerData();
+    }
+};
+
+BP32Data::PackedControllerData makeFrame() {
+    BP32Data::PackedControllerData data = {};
+    data.id = 0;
+    data.axis_x = 100;
+    data.throttle = 500;
+    data.gyro[0] = 10;
+    data.accel[2] = 1000;
+    return data;
+}
+
+// Every field sets only its own bit, every element of gyro and accel is compared
+void testFieldMasks() {
+    const BP32Data::PackedControllerData base = makeFrame();
+    struct FieldChange
+    {
+        void (*change)(BP32Data::PackedControllerData &data);
+        uint16_t mask;
+    };
+    const FieldChange changes[] = {
+        {[](BP32Data::PackedControllerData &d) { d.id = 1; }, kFieldId},
+        {[](BP32Data::PackedControllerData &d) { d.dpad = 0x01; }, kFieldDpad},
+        {[](BP32Data::PackedControllerData &d) { d.axis_x = -100; }, kFieldAxisX},
+        {[](BP32Data::PackedControllerData &d) { d.axis_y = 1; }, kFieldAxisY},
+        {[](BP32Data::PackedControllerData &d) { d.axis_rx = 1; }, kFieldAxisRX},
+        {[](BP32Data::PackedControllerData &d) { d.axis_ry = 1; }, kFieldAxisRY},
+        {[](BP32Data::PackedControllerData &d) { d.brake = 1; }, kFieldBrake},
+        {[](BP32Data::PackedControllerData &d) { d.throttle = 501; }, kFieldThrottle},
+        {[](BP32Data::PackedControllerData &d) { d.buttons = 0x01; }, kFieldButtons},
+        {[](BP32Data::PackedControllerData &d) { d.misc_buttons = 0x01; }, kFieldMiscButtons},
+        {[](BP32Data::PackedControllerData &d) { d.gyro[0] = 11; }, kFieldGyro},
+        {[](BP32Data::PackedControllerData &d) { d.gyro[1] = 1; }, kFieldGyro},
+        {[](BP32Data::PackedControllerData &d) { d.gyro[2] = -1; }, kFieldGyro},
+        {[](BP32Data::PackedControllerData &d) { d.accel[0] = 1; }, kFieldAccel},
+        {[](BP32Data::PackedControllerData &d) { d.accel[1] = 1; }, kFieldAccel},
+        {[](BP32Data::PackedControllerData &d) { d.accel[2] = 999; }, kFieldAccel},
+    };
+    uint16_t all_masks = 0;
+    for (const auto &change : changes) {
+        BP32Data::ControllerDataManager manager(base);
+        BP32Data::PackedControllerData data = base;
+        change.change(data);
+        CHECK_EQ(manager.setControllerData(data), change.mask);
+        CHECK_EQ(manager.changedFields(), change.mask);
+        CHECK(manager.hasChanged(change.mask));
+        CHECK(!manager.hasChanged(static_cast<uint16_t>(kFieldAll & ~change.mask)));
+        all_masks |= change.mask;
+    }
+    CHECK_EQ(all_masks, kFieldAll);
+
+    // Several fields in one update are reported together
+    BP32Data::ControllerDataManager manager(base);
+    BP32Data::PackedControllerData data = base;
+    data.axis_x = 0;
+    data.buttons = 0x02;
+    data.accel[1] = 5;
+    CHECK_EQ(manager.setControllerData(data), kFieldAxisX | kFieldButtons | kFieldAccel);
+    CHECK_EQ(manager.axisX(), 0);
+    CHECK_EQ(manager.accelY(), 5);
+}
+
+// Callback runs only when a subscribed field changed and gets the full change mask
+void testSubscriptionFiltersFields() {
+    BP32Data::ControllerDataManager manager(makeFrame());
+    Recorder axes;
+    Recorder buttons;
+    CHECK(manager.subscribe(kFieldAxes, &Recorder::onChange, &axes));
+    CHECK(manager.subscribe(kFieldButtons, &Recorder::onChange, &buttons));
+
+    BP32Data::PackedControllerData data = makeFrame();
+    data.gyro[2] = 7;
+    CHECK_EQ(manager.setControllerData(data), kFieldGyro);
+    CHECK_EQ(axes.calls, 0);
+    CHECK_EQ(buttons.calls, 0);
+
+    data.throttle = 800;
+    data.misc_buttons = 0x04;
+    CHECK_EQ(manager.setControllerData(data), kFieldThrottle | kFieldMiscButtons);
+    CHECK_EQ(axes.calls, 1);
+    CHECK_EQ(axes.changed_fields, kFieldThrottle | kFieldMiscButtons);
+    CHECK_EQ(axes.data.throttle, 800);     // callback sees the new data
+    CHECK_EQ(buttons.calls, 0);
+
+    // Same frame again changes nothing and calls nobody
+    CHECK_EQ(manager.setControllerData(data), 0);
+    CHECK_EQ(manager.changedFields(), 0);
+    CHECK_EQ(axes.calls, 1);
+    CHECK_EQ(buttons.calls, 0);
+
+    data.buttons = BP32Data::ControllerButtonConst::kButtonA;
+    manager = data;
+    CHECK(manager.a());
+    CHECK_EQ(axes.calls, 1);
+    CHECK_EQ(buttons.calls, 1);
+    CHECK_EQ(buttons.changed_fields, kFieldButtons);
+}
+
+// Two subscriptions at most, unsubscribe frees the entry of the same callback and context only
+void testSubscriptionLimitAndUnsubscribe() {
+    BP32Data::ControllerDataManager manager;
+    Recorder first;
+    Recorder second;
+    Recorder third;
+    CHECK(!manager.subscribe(kFieldAll, nullptr, &first));
+    CHECK(manager.subscribe(kFieldAll, &Recorder::onChange, &first));
+    CHECK(manager.subscribe(kFieldAll, &Recorder::onChange, &second));
+    static_assert(BP32Data::ControllerDataManager::kMaxSubscriptions == 2, "test expects two subscriptions");
+    CHECK(!manager.subscribe(kFieldAll, &Recorder::onChange, &third));
+
+    BP32Data::PackedControllerData data = {};
+    data.axis_y = 3;
+    manager.setControllerData(data);
+    CHECK_EQ(first.calls, 1);
+    CHECK_EQ(second.calls, 1);
+    CHECK_EQ(third.calls, 0);
+
+    manager.unsubscribe(&Recorder::onChange, &third);     // not subscribed, nothing removed
+    manager.unsubscribe(&Recorder::onChange, &first);
+    data.axis_y = 4;
+    manager.setControllerData(data);
+    CHECK_EQ(first.calls, 1);
+    CHECK_EQ(second.calls, 2);
+
+    // Freed entry is reused
+    CHECK(manager.subscribe(kFieldAxisY, &Recorder::onChange, &third));
+    data.axis_y = 5;
+    manager.setControllerData(data);
+    CHECK_EQ(second.calls, 3);
+    CHECK_EQ(third.calls, 1);
+}
+
+// Table subscriber is told about the neutral frame once when the slot enters failsafe
+void testFailsafeEntryNotifies() {
+    HostTest::resetWorld();
+    BP32Data::ControllerTable table;
+    table.setFailsafeConfig({250, 1});
+    Recorder recorder;
+    CHECK(table.subscribe(0, kFieldAll, &Recorder::onChange, &recorder));
+    CHECK(!table.subscribe(BP32Data::kMaxControllers, kFieldAll, &Recorder::onChange, &recorder));
+
+    BP32Data::PackedControllerData frame = makeFrame();
+    frame.buttons = BP32Data::ControllerButtonConst::kButtonB;
+    CHECK(table.update(0, frame, 1000));
+    CHECK_EQ(recorder.calls, 1);
+    CHECK_EQ(recorder.data.buttons, BP32Data::ControllerButtonConst::kButtonB);
+
+    CHECK_EQ(table.updateFailsafe(1250), 0);
+    CHECK_EQ(recorder.calls, 1);
+    CHECK_EQ(table.updateFailsafe(1251), 0x01);
+    CHECK_EQ(recorder.calls, 2);
+    CHECK_EQ(recorder.data.id, -1);
+    CHECK_EQ(recorder.data.axis_x, 0);
+    CHECK_EQ(recorder.data.throttle, 0);
+    CHECK_EQ(recorder.data.buttons, 0);
+    CHECK_EQ(recorder.data.gyro[0], 0);
+    CHECK_EQ(recorder.data.accel[2], 0);
+    CHECK_EQ(recorder.changed_fields, kFieldId | kFieldAxisX | kFieldThrottle | kFieldButtons |
+                                      kFieldGyro | kFieldAccel);
+    CHECK(!table.get(0)->isControllerConnected());
+
+    // Staying in failsafe publishes nothing more
+    CHECK_EQ(table.updateFailsafe(2000), 0);
+    CHECK_EQ(recorder.calls, 2);
+}
+}   // namespace
+
+int main() {
+    testFieldMasks();
+    testSubscriptionFiltersFields();
+    testSubscriptionLimitAndUnsubscribe();
+    testFailsafeEntryNotifies();
+    return HostTest::finish("test_controller_data_manager");
+}
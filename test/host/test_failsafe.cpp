@@ -0,0 +1,189 @@
+/*
+    Receiver failsafe with link dropouts injected into the RF24 stand-in:
+    neutral output once per lost link, recovery hysteresis and parity recovery in no-ACK mode.
+*/
+#include "test_support.h"
+#include "nrf24_driver.h"
+
+namespace
+{
+constexpr unsigned long kTickUs = 10000;
+// Frame lost on air blocks the controller for all retries of every chunk, about 60 ms
+constexpr unsigned long kFailedSendMaxMs = 70;
+
+// Controller sending to one receiver, air is cut while is_blackout is set
+struct Link
+{
+    Link(): controller(9, 10), receiver(7, 8) {
+        HostTest::resetWorld();
+        CHECK(controller.init());
+        CHECK(receiver.init());
+        uint8_t address[RF24Driver::kAddressSize];
+        memcpy(address, RF24Driver::address_tx, sizeof(address));
+        CHECK(receiver.setRxAddress(RF24Driver::kFirstRxPipe, address));
+        receiver.pollControllers();     // receiver starts listening on its first poll
+        RF24Host::setLossHook([this](const RF24&, const uint8_t* data, uint8_t, uint8_t) {
+            return is_blackout || ((lost_chunks >> data[1]) & 1U);
+        });
+    }
+
+    // Send frame unless skipped, poll receiver and wait for next tick, a tick lasts longer while retrying
+    // @return true if receiver published an update
+    bool tick(int32_t axis_x, bool is_sent = true) {
+        const unsigned long tick_end_us = ArduinoHost::peekMicros() + kTickUs;
+        if (is_sent) {
+            BP32Data::PackedControllerData frame = {};
+            frame.axis_x = axis_x;
+            frame.buttons = BP32Data::ControllerButtonConst::kButtonA;
+            controller.sendGamepadData(frame);
+        }
+        const bool is_published = receiver.receiveGamepadData(published);
+        if (static_cast<long>(ArduinoHost::peekMicros() - tick_end_us) < 0) {
+            ArduinoHost::setMicros(tick_end_us);
+        }
+        return is_published;
+    }
+
+    const RF24Driver::LinkStats& stats() const { return receiver.getLinkStats(); }
+
+    RF24Driver::NRF24Controller controller;
+    RF24Driver::NRF24Controller receiver;
+    BP32Data::PackedControllerData published = {};
+    bool is_blackout = false;
+    uint8_t lost_chunks = 0;    // bit per chunk index lost on every frame
+};
+
+// Steady frames until slot leaves failsafe
+void settle(Link& link) {
+    for (int i = 0; i < 10; ++i) {
+        link.tick(i);
+    }
+    CHECK(!link.receiver.getControllers().isFailsafe(0));
+}
+
+void testStartsInFailsafeAndRecovers() {
+    Link link;
+    CHECK(link.receiver.getControllers().isFailsafe(0));
+    const uint8_t recovery_frames = BP32Data::kDefaultFailsafeConfig.recovery_frames;
+    for (int i = 1; i < recovery_frames; ++i) {
+        CHECK(!link.tick(i));
+    }
+    CHECK(link.tick(100));
+    CHECK_EQ(link.published.axis_x, 100);
+    CHECK(!link.receiver.getControllers().isFailsafe(0));
+}
+
+void testDropoutPublishesNeutralOnce() {
+    Link link;
+    settle(link);
+    const unsigned long last_frame_ms = link.receiver.getControllers().lastSeenMs(0);
+    link.is_blackout = true;
+    unsigned int neutral_count = 0;
+    unsigned long neutral_ms = 0;
+    while (millis() - last_frame_ms < 600) {
+        if (link.tick(0)) {
+            ++neutral_count;
+            neutral_ms = millis();
+            CHECK_EQ(link.published.id, -1);
+            CHECK_EQ(link.published.axis_x, 0);
+            CHECK_EQ(link.published.buttons, 0);
+        }
+    }
+    CHECK_EQ(neutral_count, 1);
+    CHECK(neutral_ms - last_frame_ms > BP32Data::kDefaultFailsafeConfig.timeout_ms);
+    CHECK(neutral_ms - last_frame_ms <= BP32Data::kDefaultFailsafeConfig.timeout_ms + kFailedSendMaxMs);
+    CHECK_EQ(link.stats().rx_failsafe_events, 1);
+    CHECK(link.receiver.getControllers().isFailsafe(0));
+
+    // Link is back: first frames only count towards recovery
+    link.is_blackout = false;
+    CHECK(!link.tick(1));
+    CHECK(!link.tick(2));
+    CHECK(link.tick(3));
+    CHECK_EQ(link.published.axis_x, 3);
+
+    // Second dropout is reported again
+    link.is_blackout = true;
+    const unsigned long second_dropout_ms = millis();
+    while (millis() - second_dropout_ms < 400) {
+        link.tick(0);
+    }
+    CHECK_EQ(link.stats().rx_failsafe_events, 2);
+}
+
+void testShortDropoutKeepsOutput() {
+    Link link;
+    settle(link);
+    link.is_blackout = true;
+    // Just below timeout, the last frame stays published
+    const unsigned long last_frame_ms = link.receiver.getControllers().lastSeenMs(0);
+    while (millis() - last_frame_ms + kFailedSendMaxMs < BP32Data::kDefaultFailsafeConfig.timeout_ms) {
+        CHECK(!link.tick(0));
+    }
+    CHECK(!link.receiver.getControllers().isFailsafe(0));
+    CHECK_EQ(link.stats().rx_failsafe_events, 0);
+    link.is_blackout = false;
+    CHECK(link.tick(42));
+    CHECK_EQ(link.published.axis_x, 42);
+}
+
+// Frames further apart than timeout never count as steady
+void testSparseFramesDoNotRecover() {
+    Link link;
+    for (int i = 0; i < 100; ++i) {
+        const bool is_sent = i % 30 == 0;   // every 300 ms
+        CHECK(!link.tick(i, is_sent) || link.published.id == -1);
+    }
+    CHECK(link.receiver.getControllers().isFailsafe(0));
+}
+
+void testFlappingLinkWithinTimeout() {
+    Link link;
+    settle(link);
+    unsigned int published = 0;
+    const unsigned long start_ms = millis();
+    for (int i = 0; millis() - start_ms < 2000; ++i) {
+        // Bursts of 150 ms loss with 50 ms of link in between
+        link.is_blackout = (millis() - start_ms) % 200 < 150;
+        if (link.tick(i)) {
+            ++published;
+            CHECK_EQ(link.published.axis_x, i);
+        }
+    }
+    CHECK(published >= 10);    // at least one frame gets through in every gap
+    CHECK_EQ(link.stats().rx_failsafe_events, 0);
+}
+
+void testNoAckParityRebuildsLostChunk() {
+    Link link;
+    link.controller.setNoAckMode(true);
+    settle(link);
+    const uint32_t recovered_before = link.stats().rx_chunks_recovered;
+    // Every frame loses its second chunk, parity chunk rebuilds it
+    link.lost_chunks = 0x02;
+    for (int i = 0; i < 50; ++i) {
+        CHECK(link.tick(1000 + i));
+        CHECK_EQ(link.published.axis_x, 1000 + i);
+        CHECK_EQ(link.published.buttons, BP32Data::ControllerButtonConst::kButtonA);
+    }
+    CHECK_EQ(link.stats().rx_chunks_recovered - recovered_before, 50);
+    CHECK_EQ(link.stats().rx_failsafe_events, 0);
+
+    // Frames losing more than one chunk can not be rebuilt, link times out
+    link.lost_chunks = 0x03;
+    for (int i = 0; i < 30; ++i) {
+        link.tick(i);
+    }
+    CHECK_EQ(link.stats().rx_failsafe_events, 1);
+}
+}   // namespace
+
+int main() {
+    testStartsInFailsafeAndRecovers();
+    testDropoutPublishesNeutralOnce();
+    testShortDropoutKeepsOutput();
+    testSparseFramesDoNotRecover();
+    testFlappingLinkWithinTimeout();
+    testNoAckParityRebuildsLostChunk();
+    return HostTest::finish("test_failsafe");
+}
@@ -0,0 +1,71 @@
+/*
+    Firmware built like env:pico: generic Arduino backend of hal.h with RP2040 pins,
+    and settings in flash emulated EEPROM which needs begin() and commit().
+*/
+#include "test_support.h"
+#include "hal.h"
+#include "pin_config.h"
+#include "joystick_shield.h"
+#include "settings_store.h"
+
+#include <EEPROM.h>
+#include "hal_host_state.h"   // pin state behind digitalRead / analogRead of the stand-in core
+
+namespace
+{
+static_assert(JOYSTICK_X_PIN == 26 && JOYSTICK_Y_PIN == 27, "Pico ADC pins are GP26 and GP27");
+
+void testPinsUseCoreCalls() {
+    HostTest::resetWorld();
+    JoystickShieldSetup();
+    const uint32_t button_pins = (1UL << A_PIN) | (1UL << B_PIN) | (1UL << C_PIN) | (1UL << D_PIN) |
+                                 (1UL << E_PIN) | (1UL << F_PIN) | (1UL << JOYSTICK_BUTTON_PIN);
+    CHECK_EQ(Hal::Host::state().pullups, button_pins);
+
+    Hal::output<Board::LowVoltageLed>();
+    Hal::write<Board::LowVoltageLed>(true);
+    CHECK(Hal::Host::state().outputs & (1UL << LOW_VOLTAGE_LED_PIN));
+    CHECK(Hal::read<Board::LowVoltageLed>());
+    Hal::write<Board::LowVoltageLed>(false);
+    CHECK(!Hal::read<Board::LowVoltageLed>());
+}
+
+void testButtonsAndJoystick() {
+    HostTest::resetWorld();
+    CHECK_EQ(ReadButtonMask(), 0);
+    // Pressed buttons pull their pins low
+    Hal::Host::state().levels &= ~((1UL << B_PIN) | (1UL << F_PIN) | (1UL << JOYSTICK_BUTTON_PIN));
+    CHECK_EQ(ReadButtonMask(), ButtonMask::kButtonB | ButtonMask::kButtonF | ButtonMask::kJoystickButton);
+
+    Hal::Host::state().adc[JOYSTICK_X_PIN] = 900;
+    Hal::Host::state().adc[JOYSTICK_Y_PIN] = 100;
+    JoystickData data = {};
+    ReadJoystickData(&data);
+    CHECK_EQ(data.x_raw, 900);
+    CHECK_EQ(data.y_raw, 100);
+}
+
+void testSettingsAreCommitted() {
+    HostTest::resetWorld();
+    EEPROM.hostErase();
+    SettingsStore store;
+    CHECK(EEPROM.hostBeginSize() > 0);
+    Settings settings;
+    SettingsStore::LoadDefaults(&settings);
+    settings.radio_channel = 42;
+    CHECK(store.Save(settings));
+    CHECK_EQ(EEPROM.hostCommitCount(), 1);
+
+    SettingsStore reloaded;
+    Settings loaded;
+    CHECK(reloaded.Load(&loaded));
+    CHECK_EQ(loaded.radio_channel, 42);
+}
+}   // namespace
+
+int main() {
+    testPinsUseCoreCalls();
+    testButtonsAndJoystick();
+    testSettingsAreCommitted();
+    return HostTest::finish("test_hal_rp2040");
+}
@@ -0,0 +1,145 @@
+/*
+    Complementary filter replayed on an IMU trace.
+    Default trace has the true gravity direction, the estimate is checked against it.
+    Other traces (raw columns only, e.g. recorded from hardware) can be passed as argument,
+    they are checked for a plausible gravity magnitude and exact gyro rate conversion.
+
+    Usage: test_imu_filter [trace.csv]
+*/
+#include "test_support.h"
+#include "imu_filter.h"
+
+#include <math.h>
+#include <vector>
+
+namespace
+{
+struct TraceRow {
+    uint32_t time_us;
+    Imu::RawSample sample;
+    int32_t truth_mg[3];
+    bool has_truth;
+};
+
+bool loadTrace(const char* path, std::vector<TraceRow>* rows) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        printf("Unable to open %s\n", path);
+        return false;
+    }
+    char line[160];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        long values[10];
+        int count = 0;
+        char* cursor = line;
+        while (count < 10) {
+            char* end = nullptr;
+            values[count] = strtol(cursor, &end, 10);
+            if (end == cursor) {
+                break;
+            }
+            ++count;
+            cursor = *end == ',' ? end + 1 : end;
+        }
+        if (count != 7 && count != 10) {
+            printf("Malformed trace line: %s", line);
+            fclose(file);
+            return false;
+        }
+        TraceRow row = {};
+        row.time_us = static_cast<uint32_t>(values[0]);
+        for (int i = 0; i < 3; ++i) {
+            row.sample.accel[i] = static_cast<int16_t>(values[1 + i]);
+            row.sample.gyro[i] = static_cast<int16_t>(values[4 + i]);
+            row.truth_mg[i] = count == 10 ? static_cast<int32_t>(values[7 + i]) : 0;
+        }
+        row.has_truth = count == 10;
+        rows->push_back(row);
+    }
+    fclose(file);
+    return !rows->empty();
+}
+
+double angleDeg(const double (&a)[3], const double (&b)[3]) {
+    const double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    const double norm = sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]) *
+                        sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
+    return norm > 0 ? acos(fmax(-1.0, fmin(1.0, dot / norm))) * 180.0 / M_PI : 180.0;
+}
+
+struct ErrorStats {
+    double max_deg = 0;
+    double sum_sq = 0;
+    unsigned int count = 0;
+
+    void add(double error_deg) {
+        max_deg = fmax(max_deg, error_deg);
+        sum_sq += error_deg * error_deg;
+        ++count;
+    }
+    double rms() const { return count > 0 ? sqrt(sum_sq / count) : 0; }
+};
+
+void replay(const std::vector<TraceRow>& rows) {
+    constexpr uint32_t kSettleUs = 1000000;     // estimate starts from first accel sample
+    Imu::ComplementaryFilter filter;
+    ErrorStats filtered;
+    ErrorStats raw;
+    double min_magnitude = 1e9;
+    double max_magnitude = 0;
+    uint32_t previous_us = rows.front().time_us;
+
+    for (const TraceRow& row : rows) {
+        filter.update(row.sample, row.time_us - previous_us);
+        previous_us = row.time_us;
+        CHECK(filter.isInitialized());
+        for (uint8_t i = 0; i < 3; ++i) {
+            CHECK_EQ(filter.rateDps(i), static_cast<int32_t>(row.sample.gyro[i]) * 10 / Imu::kGyroCountsPerDps10);
+        }
+        if (row.time_us - rows.front().time_us < kSettleUs) {
+            continue;
+        }
+        const double estimate[3] = {static_cast<double>(filter.gravityMg(0)),
+                                    static_cast<double>(filter.gravityMg(1)),
+                                    static_cast<double>(filter.gravityMg(2))};
+        const double magnitude = sqrt(estimate[0] * estimate[0] + estimate[1] * estimate[1] +
+                                      estimate[2] * estimate[2]);
+        min_magnitude = fmin(min_magnitude, magnitude);
+        max_magnitude = fmax(max_magnitude, magnitude);
+        if (!row.has_truth) {
+            continue;
+        }
+        const double truth[3] = {static_cast<double>(row.truth_mg[0]), static_cast<double>(row.truth_mg[1]),
+                                 static_cast<double>(row.truth_mg[2])};
+        const double measured[3] = {static_cast<double>(row.sample.accel[0]),
+                                    static_cast<double>(row.sample.accel[1]),
+                                    static_cast<double>(row.sample.accel[2])};
+        filtered.add(angleDeg(estimate, truth));
+        raw.add(angleDeg(measured, truth));
+    }
+
+    printf("gravity magnitude %.0f .. %.0f mG\n", min_magnitude, max_magnitude);
+    CHECK(min_magnitude > 850 && max_magnitude < 1150);
+    if (filtered.count > 0) {
+        printf("tilt error filtered: rms %.2f max %.2f deg, raw accel: rms %.2f max %.2f deg\n",
+               filtered.rms(), filtered.max_deg, raw.rms(), raw.max_deg);
+        CHECK(filtered.rms() < 1.5);
+        CHECK(filtered.max_deg < 4.0);
+        // Filter has to remove most of the vibration seen by the accelerometer
+        CHECK(filtered.rms() < raw.rms() / 2);
+    }
+}
+}   // namespace
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "data/imu_tilt_trace.csv";
+    std::vector<TraceRow> rows;
+    CHECK(loadTrace(path, &rows));
+    if (!rows.empty()) {
+        replay(rows);
+    }
+    return HostTest::finish("test_imu_filter");
+}
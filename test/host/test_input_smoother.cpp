@@ -0,0 +1,95 @@
+/*
+    InputSmoother interpolation, extrapolation and history reset around failsafe frames.
+*/
+#include "test_support.h"
+#include "input_smoother.h"
+
+namespace
+{
+BP32Data::PackedControllerData makeFrame(int32_t axis_x, int8_t id = 0) {
+    BP32Data::PackedControllerData data = {};
+    data.id = id;
+    data.axis_x = axis_x;
+    data.throttle = 300;
+    return data;
+}
+
+SmoothingConfig configFor(AxisSmoothing smoothing) {
+    SmoothingConfig config = kDefaultSmoothingConfig;
+    config.axes[InputMapping::kAxisX] = smoothing;
+    return config;
+}
+
+int32_t sampleX(const InputSmoother& smoother, unsigned long now_ms) {
+    BP32Data::PackedControllerData data = {};
+    CHECK(smoother.sample(now_ms, data));
+    return data.axis_x;
+}
+
+void testEmptyAndSingleFrame() {
+    InputSmoother smoother;
+    BP32Data::PackedControllerData data;
+    CHECK(!smoother.sample(0, data));
+    smoother.addFrame(makeFrame(100), 1000);
+    CHECK_EQ(sampleX(smoother, 1005), 100);     // one frame has no slope
+}
+
+void testInterpolateAndExtrapolate() {
+    InputSmoother interpolating(configFor(AxisSmoothing::kInterpolate));
+    interpolating.addFrame(makeFrame(0), 1000);
+    interpolating.addFrame(makeFrame(100), 1010);
+    CHECK_EQ(sampleX(interpolating, 1010), 0);
+    CHECK_EQ(sampleX(interpolating, 1015), 50);
+    CHECK_EQ(sampleX(interpolating, 1030), 100);
+
+    InputSmoother extrapolating(configFor(AxisSmoothing::kExtrapolate));
+    extrapolating.addFrame(makeFrame(0), 1000);
+    extrapolating.addFrame(makeFrame(100), 1010);
+    CHECK_EQ(sampleX(extrapolating, 1015), 150);
+    // Horizon bounds the overshoot, axis range bounds it too
+    CHECK_EQ(sampleX(extrapolating, 1200), InputMapping::kAxisMax);
+    BP32Data::PackedControllerData data;
+    CHECK(extrapolating.sample(1015, data));
+    CHECK_EQ(data.throttle, 300);
+}
+
+void testNeutralFrameClearsHistory() {
+    InputSmoother smoother(configFor(AxisSmoothing::kExtrapolate));
+    smoother.addFrame(makeFrame(0), 1000);
+    smoother.addFrame(makeFrame(200), 1010);
+    smoother.addFrame(makeFrame(0, -1), 1300);
+    BP32Data::PackedControllerData data;
+    CHECK(smoother.sample(1310, data));
+    CHECK_EQ(data.id, -1);
+    CHECK_EQ(data.axis_x, 0);
+}
+
+// Frame after failsafe is the first frame of new history, no slope from neutral data
+void testFrameAfterNeutralStartsHistory() {
+    for (const AxisSmoothing smoothing : {AxisSmoothing::kInterpolate, AxisSmoothing::kExtrapolate}) {
+        InputSmoother smoother(configFor(smoothing));
+        smoother.addFrame(makeFrame(0), 1000);
+        smoother.addFrame(makeFrame(100), 1010);
+        smoother.addFrame(makeFrame(0, -1), 1300);
+        smoother.addFrame(makeFrame(400), 1500);
+        // Held, not interpolated from neutral 0 and not extrapolated beyond it
+        CHECK_EQ(sampleX(smoother, 1500), 400);
+        CHECK_EQ(sampleX(smoother, 1505), 400);
+        CHECK_EQ(sampleX(smoother, 1540), 400);
+
+        // Second frame restores smoothing with slope between the two real frames
+        smoother.addFrame(makeFrame(420), 1510);
+        const int32_t expected = smoothing == AxisSmoothing::kInterpolate ? 410 : 430;
+        CHECK_EQ(sampleX(smoother, 1515), expected);
+    }
+}
+}   // namespace
+
+int main() {
+    HostTest::resetWorld();
+    testEmptyAndSingleFrame();
+    testInterpolateAndExtrapolate();
+    testNeutralFrameClearsHistory();
+    testFrameAfterNeutralStartsHistory();
+    return HostTest::finish("test_input_smoother");
+}
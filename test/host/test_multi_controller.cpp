@@ -0,0 +1,199 @@
+/*
+    Receiver serving several controllers, built with CONTROLLER_TABLE_SIZE=3: every controller
+    sends to its own reading pipe and is reassembled into its own table slot.
+*/
+#include "test_support.h"
+#include "nrf24_driver.h"
+#include "tdma_schedule.h"
+
+static_assert(BP32Data::kMaxControllers == 3, "test_multi_controller needs receiver build with 3 slots");
+
+namespace
+{
+// Pipes 2..5 share bytes 1..4 of the pipe 1 address
+constexpr uint8_t kAddressA[RF24Driver::kAddressSize] = {'P', 'A', 'D', 'T', 'X'};
+constexpr uint8_t kAddressB[RF24Driver::kAddressSize] = {'Q', 'A', 'D', 'T', 'X'};
+
+// Controller radio sending hand made chunks, so chunks of two controllers can be interleaved
+struct Transmitter {
+    Transmitter(uint16_t ce_pin, uint16_t csn_pin, const uint8_t* address): radio(ce_pin, csn_pin) {
+        CHECK(radio.begin());
+        radio.enableDynamicPayloads();
+        radio.openWritingPipe(address);
+        radio.stopListening();
+    }
+
+    bool sendChunk(const BP32Data::PackedControllerData& frame, uint8_t packet_id, uint8_t chunk) {
+        RF24Driver::Package package = {};
+        package.packetID = packet_id;
+        package.chunkIndex = chunk;
+        package.totalChunks = RF24Driver::kPackageRequiedPerPayload;
+        const size_t offset = chunk * RF24Driver::kPackageDataSize;
+        package.dataBytes = static_cast<uint8_t>(
+            min(RF24Driver::kPackageDataSize, sizeof(BP32Data::PackedControllerData) - offset));
+        memcpy(package.data, reinterpret_cast<const uint8_t*>(&frame) + offset, package.dataBytes);
+        return radio.write(&package, static_cast<uint8_t>(RF24Driver::kPackageHeaderSize + package.dataBytes));
+    }
+
+    RF24 radio;
+};
+
+BP32Data::PackedControllerData makeFrame(int32_t axis_x, uint16_t buttons) {
+    BP32Data::PackedControllerData data = {};
+    data.axis_x = axis_x;
+    data.axis_y = -axis_x;
+    data.throttle = 700;
+    data.buttons = buttons;
+    return data;
+}
+
+bool isSlotFrame(const BP32Data::ControllerTable& table, uint8_t slot, const BP32Data::PackedControllerData& frame) {
+    const auto* controller = table.get(slot);
+    if (controller == nullptr) {
+        return false;
+    }
+    const auto& data = controller->controllerData();
+    return data.axis_x == frame.axis_x && data.axis_y == frame.axis_y &&
+           data.throttle == frame.throttle && data.buttons == frame.buttons;
+}
+
+void setupReceiver(RF24Driver::NRF24Controller& receiver) {
+    CHECK(receiver.init());
+    receiver.setFailsafeConfig({250, 1});
+    uint8_t address[RF24Driver::kAddressSize];
+    memcpy(address, kAddressA, sizeof(address));
+    CHECK(receiver.setRxAddress(RF24Driver::kFirstRxPipe, address));
+    memcpy(address, kAddressB, sizeof(address));
+    CHECK(receiver.setRxAddress(RF24Driver::kFirstRxPipe + 1, address));
+    receiver.pollControllers();     // receiver starts listening on its first poll
+}
+
+// Chunks with equal packet IDs arrive interleaved, every pipe reassembles only its own
+void testInterleavedChunks() {
+    HostTest::resetWorld();
+    RF24Driver::NRF24Controller receiver(7, 8);
+    setupReceiver(receiver);
+    Transmitter a(20, 21, kAddressA);
+    Transmitter b(22, 23, kAddressB);
+    static_assert(RF24Driver::kPackageRequiedPerPayload == 2, "interleaving below is written for two chunks");
+    const auto& table = receiver.getControllers();
+
+    const BP32Data::PackedControllerData frame_a = makeFrame(300, BP32Data::ControllerButtonConst::kButtonA);
+    const BP32Data::PackedControllerData frame_b = makeFrame(-200, BP32Data::ControllerButtonConst::kButtonB);
+    ArduinoHost::setMicros(1000000);
+    CHECK(a.sendChunk(frame_a, 7, 0));
+    CHECK(b.sendChunk(frame_b, 7, 0));
+    CHECK(b.sendChunk(frame_b, 7, 1));
+    CHECK_EQ(receiver.pollControllers(), 1);     // B complete, A waits for its second chunk
+    const unsigned long b_seen_ms = millis();
+    CHECK(isSlotFrame(table, 1, frame_b));
+    CHECK(table.get(0) == nullptr);
+    CHECK_EQ(table.lastSeenMs(1), b_seen_ms);
+
+    ArduinoHost::advanceMicros(40000);
+    CHECK(a.sendChunk(frame_a, 7, 1));
+    CHECK_EQ(receiver.pollControllers(), 1);
+    const unsigned long a_seen_ms = millis();
+    CHECK(isSlotFrame(table, 0, frame_a));
+    CHECK(isSlotFrame(table, 1, frame_b));
+    CHECK_EQ(table.lastSeenMs(0), a_seen_ms);
+    CHECK_EQ(table.lastSeenMs(1), b_seen_ms);
+    CHECK_EQ(table.seenMask(), 0x03);
+    CHECK_EQ(receiver.getLinkStats().rx_frames, 2);
+    CHECK_EQ(receiver.getLinkStats().rx_chunks_dropped, 0);
+
+    // Chunk order is fully mixed: A0 B1 A1 B0, each slot still gets only its own data
+    const BP32Data::PackedControllerData next_a = makeFrame(111, 0);
+    const BP32Data::PackedControllerData next_b = makeFrame(-111, BP32Data::ControllerButtonConst::kButtonX);
+    ArduinoHost::advanceMicros(10000);
+    CHECK(a.sendChunk(next_a, 8, 0));
+    CHECK(b.sendChunk(next_b, 8, 1));
+    CHECK(a.sendChunk(next_a, 8, 1));
+    CHECK_EQ(receiver.pollControllers(), 1);
+    CHECK(b.sendChunk(next_b, 8, 0));
+    CHECK_EQ(receiver.pollControllers(), 1);
+    CHECK(isSlotFrame(table, 0, next_a));
+    CHECK(isSlotFrame(table, 1, next_b));
+    CHECK(table.get(2) == nullptr);
+}
+
+// Silent controller enters failsafe alone, the other keeps publishing
+void testFailsafePerSlot() {
+    HostTest::resetWorld();
+    RF24Driver::NRF24Controller receiver(7, 8);
+    setupReceiver(receiver);
+    Transmitter a(20, 21, kAddressA);
+    Transmitter b(22, 23, kAddressB);
+    const auto& table = receiver.getControllers();
+
+    uint8_t packet_id = 0;
+    for (int tick = 0; tick < 50; ++tick, ++packet_id) {
+        const BP32Data::PackedControllerData frame = makeFrame(tick, 0);
+        CHECK(a.sendChunk(frame, packet_id, 0));
+        CHECK(a.sendChunk(frame, packet_id, 1));
+        if (tick < 10) {
+            CHECK(b.sendChunk(frame, packet_id, 0));
+        }
+        receiver.pollControllers();
+        if (tick < 10) {
+            CHECK(b.sendChunk(frame, packet_id, 1));
+            receiver.pollControllers();
+        }
+        ArduinoHost::advanceMicros(10000);
+    }
+    CHECK(!table.isFailsafe(0));
+    CHECK(table.isFailsafe(1));
+    CHECK(isSlotFrame(table, 0, makeFrame(49, 0)));
+    CHECK_EQ(receiver.getLinkStats().rx_failsafe_events, 1);
+    CHECK(millis() - table.lastSeenMs(1) > 250);
+    CHECK(millis() - table.lastSeenMs(0) < 20);
+}
+
+// Controllers on different pipes with different ids get own TDMA slots from the beacon layout
+void testTdmaAcrossPipes() {
+    HostTest::resetWorld();
+    RF24Driver::NRF24Controller receiver(7, 8);
+    setupReceiver(receiver);
+    RF24Driver::NRF24Controller a(20, 21);
+    RF24Driver::NRF24Controller b(22, 23);
+    CHECK(a.init());
+    CHECK(b.init());
+    uint8_t address[RF24Driver::kAddressSize];
+    memcpy(address, kAddressA, sizeof(address));
+    CHECK(a.setTxAddress(address));
+    memcpy(address, kAddressB, sizeof(address));
+    CHECK(b.setTxAddress(address));
+    // Pairing ID and controller id both differ, their sum is equal
+    a.setTdma(true, kAddressA[0], 1);
+    b.setTdma(true, kAddressB[0], 0);
+
+    constexpr uint8_t kSlotCount = 7;   // beacon and two ids for every one of three pipes
+    constexpr uint16_t kSlotUs = 2000;
+    ArduinoHost::setMicros(100000);
+    a.waitForBeacon(0);
+    b.waitForBeacon(0);
+    CHECK(receiver.sendBeacon(kSlotCount, kSlotUs));
+    CHECK_EQ(a.waitForBeacon(600), 1);
+    CHECK_EQ(b.waitForBeacon(600), 1);
+    CHECK_EQ(a.getTdmaSlot(), 2);
+    CHECK_EQ(b.getTdmaSlot(), 3);
+
+    const BP32Data::PackedControllerData frame_a = makeFrame(42, BP32Data::ControllerButtonConst::kButtonA);
+    const BP32Data::PackedControllerData frame_b = makeFrame(-42, BP32Data::ControllerButtonConst::kButtonB);
+    // Receiver drains its three entry FIFO between the slots
+    CHECK(a.sendGamepadData(frame_a));
+    CHECK_EQ(receiver.pollControllers(), 1);
+    CHECK(b.sendGamepadData(frame_b));
+    CHECK_EQ(receiver.pollControllers(), 1);
+    const auto& table = receiver.getControllers();
+    CHECK(isSlotFrame(table, 0, frame_a));
+    CHECK(isSlotFrame(table, 1, frame_b));
+}
+}   // namespace
+
+int main() {
+    testInterleavedChunks();
+    testFailsafePerSlot();
+    testTdmaAcrossPipes();
+    return HostTest::finish("test_multi_controller");
+}
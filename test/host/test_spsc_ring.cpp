@@ -0,0 +1,175 @@
+/*
+    SpscRing queue and mailbox modes, single threaded edge cases and a producer and
+    consumer running on two threads.
+*/
+#include "test_support.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <thread>
+
+namespace
+{
+void testQueueFullAndEmpty() {
+    SpscRing<int, 4> ring;
+    int item = 0;
+    CHECK(ring.empty());
+    CHECK(!ring.pop(item));
+    for (int i = 0; i < 4; ++i) {
+        CHECK(ring.push(i));
+    }
+    CHECK(ring.full());
+    CHECK(!ring.push(99));
+    for (int i = 0; i < 4; ++i) {
+        CHECK(ring.pop(item));
+        CHECK_EQ(item, i);
+    }
+    CHECK(ring.empty());
+}
+
+// Free running 8-bit indices wrap many times, order and size stay correct
+void testQueueIndexWrap() {
+    SpscRing<uint16_t, 8> ring;
+    uint16_t next_push = 0;
+    uint16_t next_pop = 0;
+    for (int round = 0; round < 1000; ++round) {
+        const int count = round % 8 + 1;
+        for (int i = 0; i < count; ++i) {
+            CHECK(ring.push(next_push++));
+        }
+        CHECK_EQ(ring.size(), count);
+        uint16_t item = 0;
+        for (int i = 0; i < count; ++i) {
+            CHECK(ring.pop(item));
+            CHECK_EQ(item, next_pop++);
+        }
+    }
+    CHECK(ring.empty());
+}
+
+void testBulkPushAndPop() {
+    SpscRing<uint8_t, 8> ring;
+    const uint8_t items[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    CHECK_EQ(ring.push(items, 5), 5);
+    // Only the remaining space is filled
+    CHECK_EQ(ring.push(items + 5, 5), 3);
+    CHECK(ring.full());
+    CHECK_EQ(ring.push(items, 1), 0);
+
+    uint8_t out[10] = {};
+    CHECK_EQ(ring.pop(out, 6), 6);
+    CHECK_EQ(out[0], 1);
+    CHECK_EQ(out[5], 6);
+    CHECK_EQ(ring.push(items, 4), 4);
+    CHECK_EQ(ring.pop(out, 10), 6);
+    CHECK_EQ(out[0], 7);
+    CHECK_EQ(out[1], 8);
+    CHECK_EQ(out[2], 1);
+    CHECK_EQ(out[5], 4);
+    CHECK_EQ(ring.pop(out, 10), 0);
+}
+
+void testMailbox() {
+    SpscRing<uint32_t, 4> ring;
+    uint32_t item = 0;
+    CHECK(!ring.peekLatest(item));
+    // Past the wrap of head, where counter skips 0
+    for (uint32_t i = 1; i <= 600; ++i) {
+        ring.publish(i);
+        CHECK(ring.peekLatest(item));
+        CHECK_EQ(item, i);
+    }
+    // Peek does not consume
+    CHECK(ring.peekLatest(item));
+    CHECK_EQ(item, 600);
+}
+
+// Items arrive complete and in order while both sides use bulk calls of varying size
+void testThreadedQueue() {
+    constexpr uint32_t kItemCount = 300000;
+    SpscRing<uint32_t, 16> ring;
+    std::thread producer([&ring]() {
+        uint32_t buffer[5];
+        uint32_t next = 0;
+        while (next < kItemCount) {
+            uint8_t count = static_cast<uint8_t>(next % 5 + 1);
+            if (next + count > kItemCount) {
+                count = static_cast<uint8_t>(kItemCount - next);
+            }
+            for (uint8_t i = 0; i < count; ++i) {
+                buffer[i] = next + i;
+            }
+            const uint8_t pushed = next % 2 == 0 ? ring.push(buffer, count) : (ring.push(buffer[0]) ? 1 : 0);
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+            next += pushed;
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t errors = 0;
+    uint32_t buffer[7];
+    while (expected < kItemCount) {
+        const uint8_t count = ring.pop(buffer, static_cast<uint8_t>(expected % 7 + 1));
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        for (uint8_t i = 0; i < count; ++i) {
+            if (buffer[i] != expected++) {
+                ++errors;
+            }
+        }
+    }
+    producer.join();
+    CHECK_EQ(errors, 0);
+    CHECK(ring.empty());
+}
+
+// Consumer never sees a torn value and never goes back in time
+void testThreadedMailbox() {
+    constexpr uint32_t kPublishCount = 300000;
+    SpscRing<uint64_t, 8> ring;
+    std::atomic<bool> is_done(false);
+    std::thread producer([&ring, &is_done]() {
+        for (uint64_t i = 1; i <= kPublishCount; ++i) {
+            ring.publish(i * 0x100000001ULL);   // both halves equal
+            if (i % 64 == 0) {
+                std::this_thread::yield();
+            }
+        }
+        is_done = true;
+    });
+
+    uint64_t last = 0;
+    uint32_t reads = 0;
+    uint32_t errors = 0;
+    while (!is_done) {
+        uint64_t value;
+        if (ring.peekLatest(value)) {
+            if ((value >> 32) != (value & 0xFFFFFFFFULL) || value < last) {
+                ++errors;
+            }
+            last = value;
+            ++reads;
+        }
+        std::this_thread::yield();
+    }
+    producer.join();
+    CHECK_EQ(errors, 0);
+    CHECK(reads > 0);
+    uint64_t value = 0;
+    CHECK(ring.peekLatest(value));
+    CHECK_EQ(value >> 32, kPublishCount);
+}
+}   // namespace
+
+int main() {
+    testQueueFullAndEmpty();
+    testQueueIndexWrap();
+    testBulkPushAndPop();
+    testMailbox();
+    testThreadedQueue();
+    testThreadedMailbox();
+    return HostTest::finish("test_spsc_ring");
+}
@@ -0,0 +1,52 @@
+/*
+    Minimal check macros for host tests, a failed check is reported and the test continues.
+*/
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include <RF24.h>
+#include <stdio.h>
+
+namespace HostTest
+{
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+// Fresh virtual clock, pins, serial buffers and air, log silenced
+inline void resetWorld() {
+    ArduinoHost::reset();
+    RF24Host::reset();
+    Log.begin(LOG_LEVEL_SILENT, &Serial, false);
+}
+
+inline int finish(const char* name) {
+    if (failures() == 0) {
+        printf("%s: passed\n", name);
+        return 0;
+    }
+    printf("%s: %d check(s) failed\n", name, failures());
+    return 1;
+}
+}   // namespace HostTest
+
+#define CHECK(condition)                                                            \
+    do {                                                                            \
+        if (!(condition)) {                                                         \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);    \
+            ++HostTest::failures();                                                 \
+        }                                                                           \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                  \
+    do {                                                                            \
+        const long long actual_value = static_cast<long long>(actual);              \
+        const long long expected_value = static_cast<long long>(expected);          \
+        if (actual_value != expected_value) {                                       \
+            printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__,      \
+                   __LINE__, #actual, #expected, actual_value, expected_value);     \
+            ++HostTest::failures();                                                 \
+        }                                                                           \
+    } while (0)
@@ -0,0 +1,232 @@
+/*
+    TDMA clock against drifting controller clocks with missed beacons, and slot timing of
+    controllers locked to beacons of a receiver through the RF24 stand-in.
+*/
+#include "test_support.h"
+#include "nrf24_driver.h"
+#include "tdma_schedule.h"
+#include "config.h"
+
+#include <math.h>
+
+namespace
+{
+constexpr uint8_t kSlotCount = 4;
+constexpr uint16_t kSlotUs = 2000;
+constexpr uint32_t kSuperframeUs = static_cast<uint32_t>(kSlotCount) * kSlotUs;
+// Slot layout of a receiver with single reading pipe, every data slot is one controller id
+constexpr Tdma::Beacon kSinglePipeLayout = {Tdma::kBeaconType, kSlotCount, kSlotUs, 0,
+                                            RF24Driver::address_tx[0], kSlotCount - 1, {0, 0}};
+
+// Controller clock running at (1 + drift) of receiver time with a fixed offset
+struct DriftingClock
+{
+    double drift;
+    double offset_us;
+
+    uint32_t toLocal(double network_us) const {
+        return static_cast<uint32_t>(llround(network_us * (1.0 + drift) + offset_us));
+    }
+    double toNetwork(uint32_t local_us) const { return (local_us - offset_us) / (1.0 + drift); }
+};
+
+void testSlotErrorUnderDrift() {
+    const DriftingClock clocks[] = {{+800e-6, 123456.0}, {-500e-6, 987.0}};
+    const uint8_t slots[] = {Tdma::assignSlot(RF24Driver::address_tx[0], 0, kSinglePipeLayout),
+                             Tdma::assignSlot(RF24Driver::address_tx[0], 1, kSinglePipeLayout)};
+    CHECK(slots[0] != slots[1]);
+    CHECK(slots[0] != Tdma::kBeaconSlot && slots[1] != Tdma::kBeaconSlot);
+
+    Tdma::Clock tdma[2];
+    double worst_error_us[2] = {0.0, 0.0};
+    for (int superframe = 0; superframe < 300; ++superframe) {
+        const double beacon_us = static_cast<double>(superframe) * kSuperframeUs;
+        // Every third beacon is missed, detection jitters by a few us
+        if (superframe % 3 != 2) {
+            Tdma::Beacon beacon = kSinglePipeLayout;
+            beacon.time_us = static_cast<uint32_t>(beacon_us);
+            for (int i = 0; i < 2; ++i) {
+                const double jitter_us = 3.0 * ((superframe * 7 + i) % 5 - 2);
+                CHECK(tdma[i].onBeacon(beacon, clocks[i].toLocal(beacon_us + Tdma::kBeaconLatencyUs + jitter_us)));
+            }
+        }
+        for (int i = 0; i < 2; ++i) {
+            // Controller asks for its slot once the beacon slot is over
+            const uint32_t local_us = clocks[i].toLocal(beacon_us + kSlotUs / 2);
+            CHECK(tdma[i].isLocked(local_us));
+            const double start_us = clocks[i].toNetwork(tdma[i].nextSlotStartUs(slots[i], local_us));
+            const double error_us = fabs(start_us - (beacon_us + slots[i] * kSlotUs));
+            if (superframe > 10 && error_us > worst_error_us[i]) {
+                worst_error_us[i] = error_us;
+            }
+        }
+    }
+    // Guard between slots has to cover this, it stays far below slot length
+    CHECK(worst_error_us[0] < 20.0);
+    CHECK(worst_error_us[1] < 20.0);
+    // Fast local clock is estimated with negative drift
+    CHECK(tdma[0].driftPpm() < -400 && tdma[0].driftPpm() > -1200);
+    CHECK(tdma[1].driftPpm() > 250 && tdma[1].driftPpm() < 750);
+}
+
+void testLockIsLostWithoutBeacons() {
+    Tdma::Clock clock;
+    CHECK(!clock.isLocked(0));
+    Tdma::Beacon beacon = kSinglePipeLayout;
+    beacon.time_us = 1000;
+    CHECK(clock.onBeacon(beacon, 50000));
+    CHECK(clock.isLocked(50000 + Tdma::kLockTimeoutUs - 1));
+    CHECK(!clock.isLocked(50000 + Tdma::kLockTimeoutUs));
+    // Invalid beacons are rejected
+    Tdma::Beacon invalid = beacon;
+    invalid.type = 0;
+    CHECK(!clock.onBeacon(invalid, 60000));
+    invalid = beacon;
+    invalid.slot_count = 1;
+    CHECK(!clock.onBeacon(invalid, 60000));
+}
+
+// Every pairing ID and controller id inside the layout gets its own slot, the rest none
+void testSlotLayout() {
+    // Receiver with three pipes and two ids per pipe
+    const Tdma::Beacon layout = {Tdma::kBeaconType, 7, kSlotUs, 0, 'P', 2, {0, 0}};
+    // Differ in both values, a sum of pairing ID and id would put them into one slot
+    CHECK_EQ(Tdma::assignSlot('P', 1, layout), 2);
+    CHECK_EQ(Tdma::assignSlot('Q', 0, layout), 3);
+
+    uint8_t used_mask = 0;
+    for (uint8_t pipe = 0; pipe < 3; ++pipe) {
+        for (int8_t id = 0; id < 2; ++id) {
+            const uint8_t slot = Tdma::assignSlot(static_cast<uint8_t>('P' + pipe), id, layout);
+            CHECK(slot != Tdma::kNoSlot && slot != Tdma::kBeaconSlot && slot < layout.slot_count);
+            CHECK((used_mask & (1U << slot)) == 0);
+            used_mask |= static_cast<uint8_t>(1U << slot);
+        }
+    }
+    CHECK_EQ(used_mask, 0x7E);
+    CHECK_EQ(Tdma::assignSlot('S', 0, layout), Tdma::kNoSlot);     // pipe beyond data slots
+    CHECK_EQ(Tdma::assignSlot('O', 0, layout), Tdma::kNoSlot);     // below base pairing ID
+    CHECK_EQ(Tdma::assignSlot('P', 2, layout), Tdma::kNoSlot);     // id beyond ids per pipe
+    CHECK_EQ(Tdma::assignSlot('P', -1, layout), Tdma::kNoSlot);
+    Tdma::Beacon no_ids = layout;
+    no_ids.ids_per_pipe = 0;
+    CHECK_EQ(Tdma::assignSlot('P', 0, no_ids), Tdma::kNoSlot);
+}
+
+// Receiver sending beacons and two controllers of one team sending in their own slots
+struct Team
+{
+    Team(): receiver(7, 8), controllers{{9, 10}, {11, 12}} {
+        HostTest::resetWorld();
+        CHECK(receiver.init());
+        uint8_t address[RF24Driver::kAddressSize];
+        memcpy(address, RF24Driver::address_tx, sizeof(address));
+        CHECK(receiver.setRxAddress(RF24Driver::kFirstRxPipe, address));
+        for (int i = 0; i < 2; ++i) {
+            CHECK(controllers[i].init());
+            controllers[i].setTdma(true, address[0], static_cast<int8_t>(i));
+        }
+        RF24Host::setLossHook([this](const RF24& sender, const uint8_t* data, uint8_t length, uint8_t attempt) {
+            const bool is_beacon = length == sizeof(Tdma::Beacon) && data[0] == Tdma::kBeaconType;
+            if (is_beacon) {
+                return is_beacon_lost;
+            }
+            for (int i = 0; i < 2; ++i) {
+                if (sender.hostCePin() == ce_pins[i] && attempt == 0 && first_write_us[i] == 0) {
+                    first_write_us[i] = ArduinoHost::peekMicros();
+                }
+            }
+            return false;
+        });
+    }
+
+    RF24Driver::NRF24Controller receiver;
+    RF24Driver::NRF24Controller controllers[2];
+    const uint16_t ce_pins[2] = {9, 11};
+    unsigned long first_write_us[2] = {0, 0};
+    bool is_beacon_lost = false;
+};
+
+void testControllersSendInOwnSlots() {
+    Team team;
+    const uint8_t slots[] = {Tdma::assignSlot(RF24Driver::address_tx[0], 0, kSinglePipeLayout),
+                             Tdma::assignSlot(RF24Driver::address_tx[0], 1, kSinglePipeLayout)};
+    CHECK(slots[0] != slots[1]);
+    // Controller with the earlier slot sends first, the program runs both on one clock
+    const int order[] = {slots[0] < slots[1] ? 0 : 1, slots[0] < slots[1] ? 1 : 0};
+
+    BP32Data::PackedControllerData frame = {};
+    unsigned long superframe_start_us = 100000;
+    for (int superframe = 0; superframe < 30; ++superframe, superframe_start_us += kSuperframeUs) {
+        ArduinoHost::setMicros(superframe_start_us);
+        // Every third beacon is lost, controllers stay locked
+        team.is_beacon_lost = superframe % 3 == 2;
+        // Beacon is written while controllers listen, a zero window only switches their radio to RX
+        for (auto& controller : team.controllers) {
+            controller.waitForBeacon(0);
+        }
+        const unsigned long beacon_us = ArduinoHost::peekMicros() + 4;   // sendBeacon reads micros() once
+        CHECK(team.receiver.sendBeacon(kSlotCount, kSlotUs));
+        // Both controllers pick the beacon up right when it arrives
+        for (auto& controller : team.controllers) {
+            CHECK_EQ(controller.waitForBeacon(600), team.is_beacon_lost ? 0 : 1);
+        }
+        for (const int i : order) {
+            CHECK_EQ(team.controllers[i].getTdmaSlot(), slots[i]);
+            team.first_write_us[i] = 0;
+            CHECK(team.controllers[i].sendGamepadData(frame));
+            // Loss hook sees the end of the first chunk on air, it falls into the first quarter of own slot
+            const long offset_us = static_cast<long>(team.first_write_us[i] - beacon_us) -
+                                   static_cast<long>(slots[i]) * kSlotUs;
+            CHECK(offset_us > 0 && offset_us < kSlotUs / 4);
+            team.receiver.pollControllers();
+        }
+    }
+}
+
+// Controller id outside of the layout stays quiet instead of sharing a slot
+void testControllerWithoutSlotIsQuiet() {
+    Team team;
+    team.controllers[1].setTdma(true, RF24Driver::address_tx[0], kSlotCount - 1);
+    team.controllers[1].waitForBeacon(0);
+    CHECK(team.receiver.sendBeacon(kSlotCount, kSlotUs));
+    CHECK(team.controllers[1].waitForBeacon(600));
+    CHECK_EQ(team.controllers[1].getTdmaSlot(), Tdma::kNoSlot);
+    const unsigned long attempts = RF24Host::stats().attempts;
+    BP32Data::PackedControllerData frame = {};
+    CHECK(!team.controllers[1].sendGamepadData(frame));
+    CHECK_EQ(RF24Host::stats().attempts, attempts);
+}
+
+void testAcquireWindowIsBounded() {
+    Team team;
+    // No beacon on air, wait ends after the window
+    const unsigned long window_us = kTdmaAcquireWindowUs;
+    const unsigned long start_us = ArduinoHost::peekMicros();
+    CHECK(!team.controllers[0].waitForBeacon(window_us));
+    const unsigned long elapsed_us = ArduinoHost::peekMicros() - start_us;
+    CHECK(elapsed_us >= window_us);
+    CHECK(elapsed_us < window_us + 100 + 5000);     // power up of radio included
+    // Short window of a fast tick
+    const unsigned long short_start_us = ArduinoHost::peekMicros();
+    CHECK(!team.controllers[0].waitForBeacon(500));
+    CHECK(ArduinoHost::peekMicros() - short_start_us < 600);
+
+    // Clock unlocks when beacons stay away
+    CHECK(team.receiver.sendBeacon(kSlotCount, kSlotUs));
+    CHECK(team.controllers[0].waitForBeacon(600));
+    CHECK(team.controllers[0].getTdmaClock().isLocked(micros()));
+    ArduinoHost::advanceMicros(Tdma::kLockTimeoutUs);
+    CHECK(!team.controllers[0].getTdmaClock().isLocked(micros()));
+}
+}   // namespace
+
+int main() {
+    testSlotErrorUnderDrift();
+    testLockIsLostWithoutBeacons();
+    testSlotLayout();
+    testControllersSendInOwnSlots();
+    testControllerWithoutSlotIsQuiet();
+    testAcquireWindowIsBounded();
+    return HostTest::finish("test_tdma");
+}
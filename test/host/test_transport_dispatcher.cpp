@@ -0,0 +1,186 @@
+/*
+    TransportDispatcher against scripted transports and against the real nRF24 driver
+    talking to a receiver through the RF24 stand-in.
+*/
+#include "test_support.h"
+#include "transport_dispatcher.h"
+#include "nrf24_driver.h"
+
+#include <climits>
+
+namespace
+{
+// Transport with scripted readiness, result and send duration
+class FakeTransport : public Transport
+{
+public:
+    explicit FakeTransport(const char* transport_name): name_(transport_name) {}
+
+    bool sendFrame(const BP32Data::PackedControllerData &data) override {
+        ++calls;
+        last_id = data.id;
+        ArduinoHost::advanceMicros(send_duration_us);
+        return result;
+    }
+    bool isReady() const override { return ready; }
+    const char* name() const override { return name_; }
+
+    bool ready = true;
+    bool result = true;
+    unsigned long send_duration_us = 0;
+    unsigned int calls = 0;
+    int last_id = -2;
+
+private:
+    const char* name_;
+};
+
+BP32Data::PackedControllerData makeFrame(int8_t id, int32_t axis_x) {
+    BP32Data::PackedControllerData data = {};
+    data.id = id;
+    data.axis_x = axis_x;
+    data.throttle = 512;
+    data.buttons = BP32Data::ControllerButtonConst::kButtonA;
+    return data;
+}
+
+void testRegistration() {
+    TransportDispatcher dispatcher;
+    FakeTransport first("first");
+    FakeTransport second("second");
+    FakeTransport third("third");
+    CHECK_EQ(dispatcher.addTransport(nullptr, 0), 0);
+    CHECK_EQ(dispatcher.addTransport(&first, 0), 0x01);
+    CHECK_EQ(dispatcher.addTransport(&second, 0), 0x02);
+    CHECK_EQ(dispatcher.addTransport(&third, 0), 0);
+
+    // Nothing is sent until transports are activated
+    CHECK_EQ(dispatcher.dispatch(makeFrame(0, 1), 0), 0);
+    CHECK_EQ(first.calls + second.calls, 0);
+}
+
+void testActiveMaskAndReadiness() {
+    TransportDispatcher dispatcher;
+    FakeTransport radio("radio");
+    FakeTransport ble("ble");
+    const uint8_t radio_bit = dispatcher.addTransport(&radio, 0);
+    const uint8_t ble_bit = dispatcher.addTransport(&ble, 0);
+
+    dispatcher.setActiveMask(radio_bit);
+    CHECK_EQ(dispatcher.getActiveMask(), radio_bit);
+    CHECK_EQ(dispatcher.dispatch(makeFrame(0, 1), 100), radio_bit);
+    CHECK_EQ(radio.calls, 1);
+    CHECK_EQ(ble.calls, 0);
+
+    dispatcher.setActiveMask(radio_bit | ble_bit);
+    ble.ready = false;
+    CHECK_EQ(dispatcher.dispatch(makeFrame(0, 2), 200), radio_bit);
+    CHECK_EQ(ble.calls, 0);
+
+    ble.ready = true;
+    radio.result = false;
+    CHECK_EQ(dispatcher.dispatch(makeFrame(0, 3), 300), ble_bit);
+    CHECK_EQ(radio.calls, 3);
+    CHECK_EQ(ble.calls, 1);
+}
+
+void testIndependentRateLimits() {
+    TransportDispatcher dispatcher;
+    FakeTransport radio("radio");
+    FakeTransport ble("ble");
+    const uint8_t radio_bit = dispatcher.addTransport(&radio, 0);
+    const uint8_t ble_bit = dispatcher.addTransport(&ble, 20000);
+    dispatcher.setActiveMask(radio_bit | ble_bit);
+    // Slow serial link takes longer than a tick, it must not hold back the radio
+    ble.send_duration_us = 6000;
+
+    const unsigned long kTickUs = 5000;
+    unsigned long now_us = 1000;
+    for (int tick = 0; tick < 100; ++tick, now_us += kTickUs) {
+        dispatcher.dispatch(makeFrame(0, tick), now_us);
+    }
+    CHECK_EQ(radio.calls, 100);
+    CHECK_EQ(ble.calls, 25);    // every 20 ms of 500 ms
+    CHECK_EQ(radio.last_id, 0);
+
+    // Failing transport is rate limited too, it is not retried on every tick
+    TransportDispatcher failing_dispatcher;
+    FakeTransport failing("failing");
+    failing.result = false;
+    failing_dispatcher.setActiveMask(failing_dispatcher.addTransport(&failing, 20000));
+    for (int tick = 0; tick < 8; ++tick) {
+        CHECK_EQ(failing_dispatcher.dispatch(makeFrame(0, tick), tick * kTickUs), 0);
+    }
+    CHECK_EQ(failing.calls, 2);
+}
+
+void testRateLimitAcrossMicrosWrap() {
+    TransportDispatcher dispatcher;
+    FakeTransport ble("ble");
+    dispatcher.setActiveMask(dispatcher.addTransport(&ble, 20000));
+
+    unsigned long now_us = ULONG_MAX - 30000;
+    unsigned int expected = 0;
+    for (int tick = 0; tick < 40; ++tick, now_us += 5000) {
+        if (dispatcher.dispatch(makeFrame(0, tick), now_us)) {
+            ++expected;
+        }
+    }
+    CHECK_EQ(ble.calls, expected);
+    CHECK_EQ(ble.calls, 10);
+}
+
+// Frames dispatched to the nRF24 transport arrive unchanged at a receiver
+void testNrf24TransportDeliversFrames() {
+    HostTest::resetWorld();
+    RF24Driver::NRF24Controller controller(9, 10);
+    RF24Driver::NRF24Controller receiver(7, 8);
+    CHECK(controller.init());
+    CHECK(receiver.init());
+    uint8_t address[RF24Driver::kAddressSize];
+    memcpy(address, RF24Driver::address_tx, sizeof(address));
+    CHECK(receiver.setRxAddress(RF24Driver::kFirstRxPipe, address));
+    receiver.pollControllers();     // receiver starts listening on its first poll
+
+    TransportDispatcher dispatcher;
+    FakeTransport ble("ble");
+    const uint8_t radio_bit = dispatcher.addTransport(&controller, 0);
+    const uint8_t ble_bit = dispatcher.addTransport(&ble, 20000);
+    dispatcher.setActiveMask(radio_bit | ble_bit);
+
+    unsigned int received = 0;
+    for (int tick = 0; tick < 50; ++tick) {
+        const BP32Data::PackedControllerData frame = makeFrame(0, tick * 10 - 250);
+        const uint8_t sent = dispatcher.dispatch(frame, micros());
+        CHECK(sent & radio_bit);
+        BP32Data::PackedControllerData data;
+        if (receiver.receiveGamepadData(data)) {
+            ++received;
+            CHECK_EQ(data.axis_x, frame.axis_x);
+            CHECK_EQ(data.throttle, frame.throttle);
+            CHECK_EQ(data.buttons, frame.buttons);
+        }
+        ArduinoHost::advanceMicros(5000);
+    }
+    // Slot starts in failsafe, its first frames only count towards recovery
+    CHECK_EQ(received, 50 - (BP32Data::kDefaultFailsafeConfig.recovery_frames - 1));
+    CHECK_EQ(controller.getLinkStats().frames_sent, 50);
+    CHECK_EQ(controller.getLinkStats().frames_failed, 0);
+
+    // Radio without receiver fails, BLE keeps its own schedule
+    receiver.powerDown();
+    const uint8_t sent = dispatcher.dispatch(makeFrame(0, 0), micros());
+    CHECK_EQ(sent & radio_bit, 0);
+    CHECK_EQ(controller.getLinkStats().frames_failed, 1);
+}
+}   // namespace
+
+int main() {
+    HostTest::resetWorld();
+    testRegistration();
+    testActiveMaskAndReadiness();
+    testIndependentRateLimits();
+    testRateLimitAcrossMicrosWrap();
+    testNrf24TransportDeliversFrames();
+    return HostTest::finish("test_transport_dispatcher");
+}